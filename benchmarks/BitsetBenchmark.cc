@@ -0,0 +1,54 @@
+#include <v2d/support/Bitset.hh>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+
+namespace v2d {
+namespace {
+
+LargeBitset random_bitset(std::size_t size, std::uint64_t seed) {
+    std::mt19937_64 random(seed);
+    LargeBitset bitset(size);
+    for (auto &word : bitset.words()) {
+        word = random() & random();
+    }
+    return bitset;
+}
+
+void bitset_and(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range());
+    auto lhs = random_bitset(size, 0);
+    const auto rhs = random_bitset(size, 1);
+    for (auto _ : state) {
+        lhs &= rhs;
+        benchmark::DoNotOptimize(lhs.words().data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(size / 4));
+}
+
+void bitset_count(benchmark::State &state) {
+    const auto bitset = random_bitset(static_cast<std::size_t>(state.range()), 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bitset.count());
+    }
+}
+
+void bitset_iterate(benchmark::State &state) {
+    const auto bitset = random_bitset(static_cast<std::size_t>(state.range()), 0);
+    for (auto _ : state) {
+        std::size_t sum = 0;
+        for (auto index : bitset) {
+            sum += index;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK(bitset_and)->Arg(1000000)->Arg(10000000)->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(bitset_count)->Arg(1000000)->Arg(10000000)->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(bitset_iterate)->Arg(1000000)->Arg(10000000)->Unit(benchmark::TimeUnit::kMillisecond);
+
+} // namespace
+} // namespace v2d
@@ -31,7 +31,7 @@ struct Velocity {
 
 struct PhysicsSystem : public System {
     void update(World *world, float dt) override {
-        for (auto [entity, position, velocity] : world->view<Position, Velocity>()) {
+        for (auto [entity, position, velocity] : world->view_mut<Position, Velocity>()) {
             position->x += velocity->x * dt;
             position->y += velocity->y * dt;
         }
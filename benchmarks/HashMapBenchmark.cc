@@ -0,0 +1,87 @@
+#include <v2d/support/HashMap.hh>
+#include <v2d/support/Vector.hh>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+
+namespace v2d {
+namespace {
+
+Vector<std::uint64_t> random_keys(std::int64_t count, std::uint64_t seed) {
+    std::mt19937_64 random(seed);
+    Vector<std::uint64_t> keys;
+    keys.ensure_capacity(static_cast<std::uint32_t>(count));
+    for (std::int64_t i = 0; i < count; i++) {
+        keys.push(random());
+    }
+    return keys;
+}
+
+template <typename Map>
+void insert(benchmark::State &state) {
+    const auto keys = random_keys(state.range(), 0);
+    for (auto _ : state) {
+        Map map;
+        for (auto key : keys) {
+            map[key] = key;
+        }
+        benchmark::DoNotOptimize(map);
+    }
+}
+
+template <typename Map>
+void lookup(benchmark::State &state, bool hit) {
+    const auto keys = random_keys(state.range(), 0);
+    const auto queries = hit ? random_keys(state.range(), 0) : random_keys(state.range(), 1);
+    Map map;
+    for (auto key : keys) {
+        map[key] = key;
+    }
+    for (auto _ : state) {
+        std::uint64_t found = 0;
+        for (auto key : queries) {
+            found += map.contains(key) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+using V2dMap = HashMap<std::uint64_t, std::uint64_t>;
+using StdMap = std::unordered_map<std::uint64_t, std::uint64_t>;
+
+void hash_map_insert(benchmark::State &state) {
+    insert<V2dMap>(state);
+}
+
+void unordered_map_insert(benchmark::State &state) {
+    insert<StdMap>(state);
+}
+
+void hash_map_lookup_hit(benchmark::State &state) {
+    lookup<V2dMap>(state, true);
+}
+
+void unordered_map_lookup_hit(benchmark::State &state) {
+    lookup<StdMap>(state, true);
+}
+
+void hash_map_lookup_miss(benchmark::State &state) {
+    lookup<V2dMap>(state, false);
+}
+
+void unordered_map_lookup_miss(benchmark::State &state) {
+    lookup<StdMap>(state, false);
+}
+
+BENCHMARK(hash_map_insert)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(unordered_map_insert)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(hash_map_lookup_hit)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(unordered_map_lookup_hit)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(hash_map_lookup_miss)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(unordered_map_lookup_miss)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+
+} // namespace
+} // namespace v2d
@@ -0,0 +1,113 @@
+#include <v2d/ecs/Component.hh>
+#include <v2d/ecs/World.hh>
+#include <v2d/support/Allocator.hh>
+
+#include <benchmark/benchmark.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <random>
+
+namespace v2d {
+namespace {
+
+enum class ComponentId {
+    Position = 0,
+};
+
+struct Position {
+    V2D_DECLARE_COMPONENT(ComponentId::Position);
+
+    float x;
+    float y;
+    Position(float x, float y) : x(x), y(y) {}
+};
+
+// Counts data TLB load misses on the calling thread. Reports -1 if the counter is unavailable, e.g. because of
+// perf_event_paranoid.
+class DtlbMissCounter {
+    int m_fd;
+
+public:
+    DtlbMissCounter() {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.size = sizeof(perf_event_attr);
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    DtlbMissCounter(const DtlbMissCounter &) = delete;
+    DtlbMissCounter(DtlbMissCounter &&) = delete;
+    ~DtlbMissCounter() {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    DtlbMissCounter &operator=(const DtlbMissCounter &) = delete;
+    DtlbMissCounter &operator=(DtlbMissCounter &&) = delete;
+
+    void start() {
+        ::ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    void stop() { ::ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0); }
+    double read() const {
+        std::uint64_t count = 0;
+        if (m_fd < 0 || ::read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+            return -1.0;
+        }
+        return static_cast<double>(count);
+    }
+};
+
+// Looks up components of entities in random order, so that nearly every access to the sparse and storage arrays lands
+// on a different page.
+void random_lookup(benchmark::State &state, Allocator *allocator) {
+    World world;
+    world.set_allocator(allocator);
+    const auto count = static_cast<EntityId>(state.range());
+    for (EntityId i = 0; i < count; i++) {
+        world.create_entity().add<Position>(2, 4);
+    }
+    std::mt19937_64 random(0);
+    Vector<EntityId> order;
+    order.ensure_capacity(1000000);
+    for (std::uint32_t i = 0; i < 1000000; i++) {
+        order.push(random() % count);
+    }
+
+    DtlbMissCounter counter;
+    double misses = 0.0;
+    for (auto _ : state) {
+        counter.start();
+        for (EntityId id : order) {
+            benchmark::DoNotOptimize(world.get_component<Position>(id));
+        }
+        counter.stop();
+        misses += counter.read();
+    }
+    state.counters["dtlb_misses"] = benchmark::Counter(misses, benchmark::Counter::kAvgIterations);
+}
+
+void random_lookup_default(benchmark::State &state) {
+    random_lookup(state, nullptr);
+}
+
+void random_lookup_huge_pages(benchmark::State &state) {
+    HugePageAllocator allocator;
+    random_lookup(state, &allocator);
+}
+
+BENCHMARK(random_lookup_default)->Arg(1000000)->Arg(10000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(random_lookup_huge_pages)->Arg(1000000)->Arg(10000000)->Unit(benchmark::TimeUnit::kMillisecond);
+
+} // namespace
+} // namespace v2d
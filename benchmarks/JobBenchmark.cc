@@ -0,0 +1,82 @@
+#include <v2d/support/JobSystem.hh>
+#include <v2d/support/Vector.hh>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+
+namespace v2d {
+namespace {
+
+constexpr std::uint32_t k_job_count = 65536;
+constexpr std::uint32_t k_element_count = 1u << 22;
+
+// Cost of spawning and running empty jobs.
+void job_spawn(benchmark::State &state) {
+    JobSystem jobs;
+    for (auto _ : state) {
+        JobCounter counter;
+        for (std::uint32_t i = 0; i < k_job_count; i++) {
+            jobs.spawn(counter, [] {});
+        }
+        jobs.wait(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * k_job_count);
+}
+
+// Fork-join overhead with a deep tree of small jobs.
+std::uint64_t fibonacci(JobSystem &jobs, std::uint32_t n) {
+    if (n < 16) {
+        return n < 2 ? n : fibonacci(jobs, n - 1) + fibonacci(jobs, n - 2);
+    }
+    std::uint64_t lhs;
+    JobCounter counter;
+    jobs.spawn(counter, [&jobs, &lhs, n] {
+        lhs = fibonacci(jobs, n - 1);
+    });
+    const auto rhs = fibonacci(jobs, n - 2);
+    jobs.wait(counter);
+    return lhs + rhs;
+}
+
+void job_fibonacci(benchmark::State &state) {
+    JobSystem jobs;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fibonacci(jobs, 30));
+    }
+}
+
+void transform_serial(benchmark::State &state) {
+    Vector<float> values;
+    values.ensure_size(k_element_count, 1.0f);
+    for (auto _ : state) {
+        for (auto &value : values) {
+            value = std::sqrt(value * value + 1.0f);
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+}
+
+void transform_parallel_for(benchmark::State &state) {
+    JobSystem jobs;
+    Vector<float> values;
+    values.ensure_size(k_element_count, 1.0f);
+    for (auto _ : state) {
+        jobs.parallel_for(values.size(), static_cast<std::uint32_t>(state.range()),
+                          [&values](std::uint32_t begin, std::uint32_t end) {
+                              for (std::uint32_t i = begin; i < end; i++) {
+                                  values[i] = std::sqrt(values[i] * values[i] + 1.0f);
+                              }
+                          });
+        benchmark::DoNotOptimize(values.data());
+    }
+}
+
+BENCHMARK(job_spawn)->Unit(benchmark::TimeUnit::kMillisecond)->UseRealTime();
+BENCHMARK(job_fibonacci)->Unit(benchmark::TimeUnit::kMillisecond)->UseRealTime();
+BENCHMARK(transform_serial)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(transform_parallel_for)->Arg(1024)->Arg(16384)->Unit(benchmark::TimeUnit::kMillisecond)->UseRealTime();
+
+} // namespace
+} // namespace v2d
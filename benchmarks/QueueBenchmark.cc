@@ -0,0 +1,112 @@
+#include <v2d/support/Array.hh>
+#include <v2d/support/Queue.hh>
+#include <v2d/support/Vector.hh>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+namespace v2d {
+namespace {
+
+constexpr std::uint32_t k_item_count = 1u << 20;
+constexpr std::uint32_t k_capacity = 1024;
+constexpr std::uint32_t k_max_batch = 64;
+
+// Pushes `count` items into `queue`, `batch` at a time, yielding while it is full so that the benchmark still makes
+// progress when there are fewer cores than threads.
+template <typename Queue>
+void produce(Queue &queue, std::uint32_t count, std::uint32_t batch) {
+    Array<std::uint64_t, k_max_batch> items{};
+    const auto &elems = items;
+    for (std::uint32_t pushed = 0; pushed < count;) {
+        if (batch == 1) {
+            if (queue.try_push(pushed)) {
+                pushed++;
+            } else {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+        const auto size = std::min(batch, count - pushed);
+        for (std::uint32_t i = 0; i < size; i++) {
+            items[i] = pushed + i;
+        }
+        const auto batch_pushed = queue.push_batch({elems.data(), size});
+        if (batch_pushed == 0) {
+            std::this_thread::yield();
+        }
+        pushed += batch_pushed;
+    }
+}
+
+// Pops `count` items from `queue` on the calling thread, `batch` at a time.
+template <typename Queue>
+std::uint64_t consume(Queue &queue, std::uint32_t count, std::uint32_t batch) {
+    Array<std::uint64_t, k_max_batch> items{};
+    std::uint64_t sum = 0;
+    for (std::uint32_t popped = 0; popped < count;) {
+        if (batch == 1) {
+            if (auto item = queue.try_pop()) {
+                sum += *item;
+                popped++;
+            } else {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+        const auto size = queue.pop_batch({items.data(), batch});
+        if (size == 0) {
+            std::this_thread::yield();
+        }
+        for (std::uint32_t i = 0; i < size; i++) {
+            sum += items[i];
+        }
+        popped += size;
+    }
+    return sum;
+}
+
+void spsc_ring(benchmark::State &state) {
+    const auto batch = static_cast<std::uint32_t>(state.range());
+    SpscRing<std::uint64_t> ring(k_capacity);
+    for (auto _ : state) {
+        std::thread producer([&] {
+            produce(ring, k_item_count, batch);
+        });
+        benchmark::DoNotOptimize(consume(ring, k_item_count, batch));
+        producer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * k_item_count);
+}
+
+void mpsc_queue(benchmark::State &state) {
+    const auto producer_count = static_cast<std::uint32_t>(state.range(0));
+    const auto batch = static_cast<std::uint32_t>(state.range(1));
+    const auto per_producer = k_item_count / producer_count;
+    MpscQueue<std::uint64_t> queue(k_capacity);
+    for (auto _ : state) {
+        Vector<std::thread> producers;
+        for (std::uint32_t i = 0; i < producer_count; i++) {
+            producers.emplace([&] {
+                produce(queue, per_producer, batch);
+            });
+        }
+        benchmark::DoNotOptimize(consume(queue, per_producer * producer_count, batch));
+        for (auto &producer : producers) {
+            producer.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * per_producer * producer_count);
+}
+
+BENCHMARK(spsc_ring)->Arg(1)->Arg(16)->Arg(64)->Unit(benchmark::TimeUnit::kMillisecond)->UseRealTime();
+BENCHMARK(mpsc_queue)
+    ->ArgsProduct({{1, 2, 4}, {1, 16, 64}})
+    ->Unit(benchmark::TimeUnit::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace v2d
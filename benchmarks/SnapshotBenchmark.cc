@@ -0,0 +1,102 @@
+#include <v2d/ecs/Component.hh>
+#include <v2d/ecs/Snapshot.hh>
+#include <v2d/ecs/World.hh>
+
+#include <benchmark/benchmark.h>
+
+namespace v2d {
+namespace {
+
+enum class ComponentId {
+    Position = 0,
+    Velocity = 1,
+};
+
+struct Position {
+    V2D_DECLARE_COMPONENT(ComponentId::Position);
+
+    float x;
+    float y;
+    Position(float x, float y) : x(x), y(y) {}
+};
+
+struct Velocity {
+    V2D_DECLARE_COMPONENT(ComponentId::Velocity);
+
+    float x;
+    float y;
+    Velocity(float x, float y) : x(x), y(y) {}
+};
+
+void create_world(World &world, std::int64_t entity_count) {
+    for (std::int64_t i = 0; i < entity_count; i++) {
+        auto entity = world.create_entity();
+        entity.add<Position>(2, 4);
+        entity.add<Velocity>(4, 6);
+    }
+}
+
+// Moves one in every `stride` entities, simulating a tick which only touches part of the world. Components are
+// fetched individually, since iterating a mutable view hands out, and so dirties, every component.
+void simulate(World &world, std::int64_t entity_count, std::int64_t stride) {
+    for (std::int64_t i = 0; i < entity_count; i += stride) {
+        world.get_component_mut<Position>(static_cast<EntityId>(i)).x += 1.0f;
+    }
+}
+
+void snapshot_capture(benchmark::State &state) {
+    World world;
+    create_world(world, state.range(0));
+    WorldSnapshot snapshot;
+    snapshot.capture(world);
+    for (auto _ : state) {
+        state.PauseTiming();
+        simulate(world, state.range(0), state.range(1));
+        state.ResumeTiming();
+        snapshot.capture(world);
+    }
+    state.counters["pages"] = static_cast<double>(snapshot.written_pages());
+}
+
+void snapshot_restore(benchmark::State &state) {
+    World world;
+    create_world(world, state.range(0));
+    WorldSnapshot snapshot;
+    snapshot.capture(world);
+    for (auto _ : state) {
+        state.PauseTiming();
+        simulate(world, state.range(0), state.range(1));
+        state.ResumeTiming();
+        snapshot.restore(world);
+    }
+    state.counters["pages"] = static_cast<double>(snapshot.written_pages());
+}
+
+// Full deep copy of every set, for comparison.
+void snapshot_save_load(benchmark::State &state) {
+    World world;
+    create_world(world, state.range(0));
+    for (auto _ : state) {
+        world.save("/tmp/v2d-snapshot-benchmark.bin");
+        World restored;
+        restored.register_component<Position>();
+        restored.register_component<Velocity>();
+        benchmark::DoNotOptimize(restored.load("/tmp/v2d-snapshot-benchmark.bin"));
+    }
+}
+
+void snapshot_args(benchmark::internal::Benchmark *benchmark) {
+    for (std::int64_t entity_count : {100000, 1000000}) {
+        for (std::int64_t stride : {1, 100, 10000}) {
+            benchmark->Args({entity_count, stride});
+        }
+    }
+    benchmark->ArgNames({"entities", "stride"});
+}
+
+BENCHMARK(snapshot_capture)->Apply(snapshot_args)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(snapshot_restore)->Apply(snapshot_args)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(snapshot_save_load)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+
+} // namespace
+} // namespace v2d
@@ -0,0 +1,105 @@
+#include <v2d/core/Transform.hh>
+#include <v2d/core/TransformSystem.hh>
+#include <v2d/ecs/Publisher.hh>
+#include <v2d/ecs/World.hh>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace v2d {
+namespace {
+
+constexpr float k_delta_time = 1.0f / 60.0f;
+constexpr int k_children_per_node = 4;
+
+// Builds a forest in which each root has a subtree of 1 + k_children_per_node + k_children_per_node^2 nodes.
+Vector<EntityId> create_scene(World &world, int node_count) {
+    Vector<EntityId> roots;
+    Vector<EntityId> nodes;
+    for (auto i = 0; i < node_count; i++) {
+        auto entity = world.create_entity();
+        entity.add<Transform>(Vec2f(0.5f));
+        if (i % 21 == 0) {
+            roots.push(entity.id());
+        } else {
+            world.set_parent(entity.id(), nodes[(i - (i % 21)) + ((i % 21) - 1) / k_children_per_node]);
+        }
+        nodes.push(entity.id());
+    }
+    world.update(k_delta_time);
+    return roots;
+}
+
+void propagate_static(benchmark::State &state) {
+    World world;
+    world.add<TransformSystem>();
+    create_scene(world, static_cast<int>(state.range()));
+    for (auto _ : state) {
+        world.update(k_delta_time);
+    }
+}
+
+void propagate_moving_roots(benchmark::State &state) {
+    World world;
+    world.add<TransformSystem>();
+    auto roots = create_scene(world, static_cast<int>(state.range()));
+    for (auto _ : state) {
+        for (const auto root : roots) {
+            world.get_component_mut<Transform>(root).set_rotation(0.1f);
+        }
+        world.update(k_delta_time);
+    }
+}
+
+void propagate_all_dirty(benchmark::State &state) {
+    World world;
+    world.add<TransformSystem>();
+    create_scene(world, static_cast<int>(state.range()));
+    for (auto _ : state) {
+        for (auto [entity, transform] : world.view_mut<Transform>()) {
+            transform->set_position(Vec2f(0.25f));
+        }
+        world.update(k_delta_time);
+    }
+}
+
+// Publishes the transform sets after a frame in which one in every `stride` trees moved. A stride of 1 moves every
+// tree, so every page is written and the publish costs as much as a full copy.
+void publish_moving_trees(benchmark::State &state) {
+    World world;
+    world.add<TransformSystem>();
+    auto roots = create_scene(world, static_cast<int>(state.range(0)));
+    ComponentPublisher publisher;
+    publisher.enable<Transform>();
+    publisher.enable<WorldTransform>();
+    // Without a reader, publishing alternates between two buffers, so fill both once up front.
+    publisher.publish(world);
+    publisher.publish(world);
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (std::uint32_t i = 0; i < roots.size(); i += static_cast<std::uint32_t>(state.range(1))) {
+            world.get_component_mut<Transform>(roots[i]).set_rotation(0.1f);
+        }
+        world.update(k_delta_time);
+        state.ResumeTiming();
+        publisher.publish(world);
+    }
+}
+
+void publish_args(benchmark::internal::Benchmark *benchmark) {
+    for (std::int64_t entity_count : {100000, 1000000}) {
+        for (std::int64_t stride : {1, 100, 10000}) {
+            benchmark->Args({entity_count, stride});
+        }
+    }
+    benchmark->ArgNames({"entities", "stride"});
+}
+
+BENCHMARK(propagate_static)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(propagate_moving_roots)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(propagate_all_dirty)->Arg(100000)->Arg(1000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(publish_moving_trees)->Apply(publish_args)->Iterations(50)->Unit(benchmark::TimeUnit::kMillisecond);
+
+} // namespace
+} // namespace v2d
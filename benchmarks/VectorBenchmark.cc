@@ -0,0 +1,61 @@
+#include <v2d/support/Vector.hh>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace v2d {
+namespace {
+
+// Not trivially copyable, so growth goes through per-element move construction.
+struct Owning {
+    std::unique_ptr<int> value;
+    Owning() = default;
+    Owning(const Owning &) = delete;
+    Owning(Owning &&) noexcept = default;
+    ~Owning() = default;
+
+    Owning &operator=(const Owning &) = delete;
+    Owning &operator=(Owning &&) noexcept = default;
+};
+
+// The same layout, marked as trivially relocatable.
+struct Relocatable : Owning {};
+
+} // namespace
+
+template <>
+struct IsTriviallyRelocatable<Relocatable> : std::true_type {};
+
+namespace {
+
+template <typename T>
+void push_large(benchmark::State &state) {
+    for (auto _ : state) {
+        LargeVector<T> vector;
+        for (auto i = 0; i < state.range(); i++) {
+            vector.emplace();
+        }
+        benchmark::DoNotOptimize(vector.data());
+    }
+}
+
+void push_large_trivial(benchmark::State &state) {
+    push_large<std::uint64_t>(state);
+}
+
+void push_large_owning(benchmark::State &state) {
+    push_large<Owning>(state);
+}
+
+void push_large_relocatable(benchmark::State &state) {
+    push_large<Relocatable>(state);
+}
+
+BENCHMARK(push_large_trivial)->Arg(1000000)->Arg(10000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(push_large_owning)->Arg(1000000)->Arg(10000000)->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(push_large_relocatable)->Arg(1000000)->Arg(10000000)->Unit(benchmark::TimeUnit::kMillisecond);
+
+} // namespace
+} // namespace v2d
@@ -1,5 +1,6 @@
 #include <v2d/core/Context.hh>
 #include <v2d/core/Transform.hh>
+#include <v2d/core/TransformSystem.hh>
 #include <v2d/core/Window.hh>
 #include <v2d/ecs/World.hh>
 #include <v2d/gfx/RenderSystem.hh>
@@ -8,6 +9,7 @@
 #include <v2d/maths/Vec.hh>
 #include <v2d/support/Assert.hh>
 #include <v2d/support/Optional.hh>
+#include <v2d/support/Trace.hh>
 #include <v2d/support/Vector.hh>
 
 #define STBI_ASSERT(x) V2D_ASSERT(x)
@@ -450,6 +452,7 @@ int main() {
              "Failed to create semaphore")
 
     v2d::World world;
+    world.add<v2d::TransformSystem>();
     world.add<v2d::RenderSystem>(context, descriptor_set);
     auto player = world.create_entity();
     player.add<v2d::Transform>(v2d::Vec2f(0.0f));
@@ -458,14 +461,18 @@ int main() {
     v2d::Vector<v2d::EntityId> entities;
 
     int foo = 0;
-    std::chrono::time_point<std::chrono::steady_clock> previous_time;
+    auto previous_time = std::chrono::steady_clock::now();
     while (!window.should_close()) {
+        V2D_TRACE_SCOPE("frame");
         auto current_time = std::chrono::steady_clock::now();
         float dt = std::chrono::duration<float, std::chrono::seconds::period>(current_time - previous_time).count();
         previous_time = current_time;
         std::uint32_t image_index = swapchain.acquire_next_image(image_available_semaphore);
         // TODO: Record command buffer here, before waiting for fence, instead?
-        vkWaitForFences(context.device(), 1, &fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+        {
+            V2D_TRACE_SCOPE("vkWaitForFences");
+            vkWaitForFences(context.device(), 1, &fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+        }
         vkResetFences(context.device(), 1, &fence);
         world.update(dt);
         vkResetCommandPool(context.device(), command_pool, 0);
@@ -530,7 +537,7 @@ int main() {
             foo = 0;
         }
 
-        for (v2d::Vec2f translation(42.0f); auto [entity, transform] : world.view<v2d::Transform>()) {
+        for (v2d::Vec2f translation(42.0f); auto [entity, transform] : world.view_mut<v2d::Transform>()) {
             transform->set_position(translation / window.resolution());
             transform->set_scale(v2d::Vec2f(42.0f) / window.resolution());
             translation += v2d::Vec2f(42.0f, 0.0f);
@@ -544,6 +551,9 @@ int main() {
         window.poll_events();
     }
     context.wait_idle();
+#ifdef V2D_TRACING
+    v2d::export_chrome_trace("trace.json");
+#endif
     vkDestroySemaphore(context.device(), rendering_finished_semaphore, nullptr);
     vkDestroySemaphore(context.device(), image_available_semaphore, nullptr);
     vkDestroyFence(context.device(), fence, nullptr);
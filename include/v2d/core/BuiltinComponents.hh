@@ -5,6 +5,8 @@ namespace v2d {
 enum class BuiltinComponents {
     Transform = 0,
     Sprite = 1,
+    Hierarchy = 2,
+    WorldTransform = 3,
 };
 
 } // namespace v2d
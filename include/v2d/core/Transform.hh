@@ -4,23 +4,81 @@
 #include <v2d/ecs/Component.hh>
 #include <v2d/maths/Vec.hh>
 
+#include <cmath>
+
 namespace v2d {
 
+class TransformSystem;
+
+// Local transform, relative to the parent entity if the entity is in a hierarchy. Any modification marks the
+// transform as dirty so that `TransformSystem` recomputes the world transform of the entity and its descendants.
 class Transform {
     V2D_DECLARE_COMPONENT(BuiltinComponents::Transform);
+    friend TransformSystem;
 
 private:
     Vec2f m_position;
     Vec2f m_scale{1.0f};
+    float m_rotation{0.0f};
+    bool m_dirty{true};
 
 public:
     explicit Transform(const Vec2f &position) : m_position(position) {}
 
-    void set_position(const Vec2f &position) { m_position = position; }
-    void set_scale(const Vec2f &scale) { m_scale = scale; }
+    void set_position(const Vec2f &position) {
+        m_position = position;
+        m_dirty = true;
+    }
+    void set_scale(const Vec2f &scale) {
+        m_scale = scale;
+        m_dirty = true;
+    }
+    void set_rotation(float rotation) {
+        m_rotation = rotation;
+        m_dirty = true;
+    }
 
     const Vec2f &position() const { return m_position; }
     const Vec2f &scale() const { return m_scale; }
+    float rotation() const { return m_rotation; }
+    bool dirty() const { return m_dirty; }
+};
+
+// Cached 2x3 affine local-to-world matrix, maintained by `TransformSystem`.
+class WorldTransform {
+    V2D_DECLARE_COMPONENT(BuiltinComponents::WorldTransform);
+
+private:
+    Vec2f m_basis_x{1.0f, 0.0f};
+    Vec2f m_basis_y{0.0f, 1.0f};
+    Vec2f m_translation;
+
+public:
+    WorldTransform() = default;
+    WorldTransform(const Vec2f &basis_x, const Vec2f &basis_y, const Vec2f &translation)
+        : m_basis_x(basis_x), m_basis_y(basis_y), m_translation(translation) {}
+    explicit WorldTransform(const Transform &local);
+
+    WorldTransform operator*(const WorldTransform &rhs) const;
+    Vec2f transform_point(const Vec2f &point) const {
+        return m_basis_x * point.x() + m_basis_y * point.y() + m_translation;
+    }
+
+    const Vec2f &basis_x() const { return m_basis_x; }
+    const Vec2f &basis_y() const { return m_basis_y; }
+    const Vec2f &translation() const { return m_translation; }
 };
 
+inline WorldTransform::WorldTransform(const Transform &local) : m_translation(local.position()) {
+    const float cos = std::cos(local.rotation());
+    const float sin = std::sin(local.rotation());
+    m_basis_x = Vec2f(cos, sin) * local.scale().x();
+    m_basis_y = Vec2f(-sin, cos) * local.scale().y();
+}
+
+inline WorldTransform WorldTransform::operator*(const WorldTransform &rhs) const {
+    return {m_basis_x * rhs.m_basis_x.x() + m_basis_y * rhs.m_basis_x.y(),
+            m_basis_x * rhs.m_basis_y.x() + m_basis_y * rhs.m_basis_y.y(), transform_point(rhs.m_translation)};
+}
+
 } // namespace v2d
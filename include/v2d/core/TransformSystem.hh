@@ -0,0 +1,26 @@
+#pragma once
+
+#include <v2d/core/Transform.hh>
+#include <v2d/ecs/Entity.hh>
+#include <v2d/ecs/System.hh>
+#include <v2d/support/Vector.hh>
+
+#include <cstddef>
+
+namespace v2d {
+
+// Computes `WorldTransform`s from local `Transform`s. Only entities whose transform is dirty, and the subtrees below
+// them, are recomputed. An entity has a `WorldTransform` exactly when it has a `Transform`, so removing the transform
+// removes the world transform on the next update. Should be added before any system which reads `WorldTransform`.
+class TransformSystem final : public System {
+    std::size_t m_hierarchy_version{0};
+    Vector<WorldTransform> m_parent_stack;
+    Vector<bool> m_recomputed_stack;
+    Vector<EntityId> m_stale_entities;
+
+public:
+    void update(World *world, float dt) override;
+    const char *name() const override { return "TransformSystem"; }
+};
+
+} // namespace v2d
@@ -1,16 +1,23 @@
 #pragma once
 
 #include <v2d/support/Array.hh>
+#include <v2d/support/Span.hh>
 #include <v2d/support/SparseSet.hh>
 #include <v2d/support/TypeErased.hh>
 
+#include <atomic>
 #include <cstddef>
+#include <limits>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace v2d {
 
 class EntityManager;
+class Hierarchy;
 using EntityId = std::size_t;
+constexpr EntityId k_null_entity = std::numeric_limits<EntityId>::max();
 
 class Entity {
     const EntityId m_id;
@@ -22,7 +29,9 @@ public:
     template <typename C, typename... Args>
     void add(Args &&...args);
     template <typename C>
-    C &get();
+    const C &get() const;
+    template <typename C>
+    C &get_mut();
     template <typename C>
     bool has() const;
     template <typename C, typename D, typename... Comps>
@@ -30,26 +39,34 @@ public:
     template <typename C>
     void remove();
 
+    void set_parent(Entity parent);
+    void remove_parent();
+
     void destroy();
     EntityId id() const { return m_id; }
 };
 
+// Views over const components are read-only and leave write tracking alone. Views over mutable components, as made by
+// `EntityManager::view_mut`, mark every component they hand out as written.
 template <typename C>
 class EntitySingleIterator {
     EntityManager *const m_manager;
+    SparseSet<std::remove_const_t<C>, EntityId> *const m_set;
     EntityId *m_current_id;
     C *m_current_component;
 
 public:
-    EntitySingleIterator(EntityManager *manager, EntityId *current_id, C *current_component)
-        : m_manager(manager), m_current_id(current_id), m_current_component(current_component) {}
+    EntitySingleIterator(EntityManager *manager, SparseSet<std::remove_const_t<C>, EntityId> *set,
+                         EntityId *current_id, C *current_component)
+        : m_manager(manager), m_set(set), m_current_id(current_id), m_current_component(current_component) {}
 
     EntitySingleIterator &operator++() {
         m_current_id++;
         m_current_component++;
         return *this;
     }
-    auto operator<=>(const EntitySingleIterator &) const = default;
+    // The component pointer moves in lockstep with the id, and the manager and set are the same for the whole view.
+    bool operator==(const EntitySingleIterator &other) const { return m_current_id == other.m_current_id; }
     std::pair<Entity, C *> operator*() const;
 };
 
@@ -58,6 +75,9 @@ class EntityIterator {
     EntityManager *const m_manager;
     EntityId m_current;
 
+    template <typename C>
+    C *component() const;
+
 public:
     EntityIterator(EntityManager *manager, EntityId current);
 
@@ -69,13 +89,14 @@ public:
 template <typename C>
 class EntitySingleView {
     EntityManager *const m_manager;
-    SparseSet<C, EntityId> &m_component_set;
+    SparseSet<std::remove_const_t<C>, EntityId> &m_component_set;
 
 public:
     EntitySingleView(EntityManager *manager);
 
     EntitySingleIterator<C> begin() const;
     EntitySingleIterator<C> end() const;
+    std::size_t size() const { return m_component_set.size(); }
 };
 
 template <typename... Comps>
@@ -89,20 +110,72 @@ public:
     EntityIterator<Comps...> end() const;
 };
 
+struct ArrayStats {
+    std::size_t used_bytes{0};
+    std::size_t reserved_bytes{0};
+};
+
+struct ComponentStats {
+    ArrayStats dense;
+    ArrayStats sparse;
+    ArrayStats storage;
+    EntityId count{0};
+    // Sparse slots which don't map to a live component, i.e. entities without this component below the highest id.
+    EntityId wasted_sparse_slots{0};
+
+    std::size_t used_bytes() const { return dense.used_bytes + sparse.used_bytes + storage.used_bytes; }
+    std::size_t reserved_bytes() const { return dense.reserved_bytes + sparse.reserved_bytes + storage.reserved_bytes; }
+
+    // The fraction of reserved memory not holding live data, counting wasted sparse slots as not live.
+    float fragmentation() const;
+};
+
 class EntityManager {
     template <typename C>
     friend class EntitySingleView;
+    friend class ComponentPublisher;
+    friend class WorldSnapshot;
 
 private:
-    Array<TypeErased<SparseSet, EntityId>, 16> m_component_sets;
+    using ComponentSet = TypeErased<SparseSet, EntityId>;
+    struct ComponentInfo {
+        std::size_t size{0};
+        bool trivially_copyable{false};
+        void (*remove)(EntityManager &manager, EntityId id){nullptr};
+        void (*assign)(ComponentSet &set, const EntityId *dense, const void *storage, EntityId size,
+                       const EntityId *sparse, EntityId sparse_size){nullptr};
+        void (*insert)(ComponentSet &set, EntityId id, const void *component){nullptr};
+        void (*transfer)(ComponentSet &from, ComponentSet &to, EntityId id){nullptr};
+    };
+
+    Array<ComponentSet, 16> m_component_sets;
+    Array<ComponentInfo, 16> m_component_infos{};
+    // Components of hibernated entities, and the mask of sets each hibernated entity had components in.
+    Array<ComponentSet, 16> m_cold_sets;
+    SparseSet<std::uint16_t, EntityId> m_hibernated;
     EntityId m_count{0};
-    EntityId m_next_id{0};
+    std::atomic<EntityId> m_next_id{0};
+    std::atomic<EntityId> m_reserved_count{0};
+    std::size_t m_hierarchy_version{0};
+    bool m_hierarchy_dirty{false};
+
+    void collect_subtree(const SparseSet<Hierarchy, EntityId> &hierarchy, EntityId root,
+                         Vector<EntityId, EntityId> &subtree) const;
+    void erase(EntityId id);
+    void unlink(EntityId id);
+    void freeze(EntityId id);
+    void thaw(EntityId id);
+    void wake_tree(EntityId root);
 
 public:
+    template <typename C>
+    void register_component();
     template <typename C, typename... Args>
     void add_component(EntityId id, Args &&...args);
     template <typename C>
-    C &get_component(EntityId id);
+    const C &get_component(EntityId id);
+    template <typename C>
+    C &get_component_mut(EntityId id);
     template <typename C>
     bool has_component(EntityId id);
     template <typename C>
@@ -111,12 +184,59 @@ public:
     Entity create_entity();
     void destroy_entity(EntityId id);
 
+    // Reserves `count` consecutive entity ids and returns the first. Unlike everything else here, this is safe to call
+    // from any thread and doesn't lock. Components can't be added concurrently, so callers should buffer them until
+    // the next sync point. The entities count towards `entity_count` after `materialise_entities`, which
+    // `World::update` calls at the start of every frame.
+    EntityId reserve_entities(EntityId count);
+    void materialise_entities();
+
+    // Moves all components of the entity to a cold store, where they are invisible to views and component accessors
+    // until the entity is woken. Entities in a hierarchy are hibernated and woken along with their whole subtree, and
+    // only roots may be hibernated. Hibernated entities can't be reparented, and saving, snapshotting and diffing the
+    // manager fail while any entity is hibernated.
+    void hibernate_entity(EntityId id);
+    void wake_entity(EntityId id);
+    void hibernate_entities(Span<const EntityId> ids);
+    void wake_entities(Span<const EntityId> ids);
+    bool is_hibernated(EntityId id) const { return m_hibernated.contains(id); }
+
+    void set_parent(EntityId child, EntityId parent);
+    void remove_parent(EntityId child);
+    void sort_hierarchy();
+    template <typename C, typename D>
+    void sort_as();
+
+    // Binary snapshots of all trivially copyable component sets. Other sets are not saved. Saving fails while any
+    // entity is hibernated. Component types must be registered before loading. Loading fails, leaving the manager
+    // untouched, if the manager isn't empty.
+    bool save(const char *path) const;
+    bool load(const char *path);
+
+    // Read-only views. Use `view_mut` to write components, which marks them dirty for snapshots and publishing.
     template <typename C>
-    EntitySingleView<C> view();
+    EntitySingleView<const C> view();
     template <typename C, typename D, typename... Comps>
-    EntityView<C, D, Comps...> view();
+    EntityView<const C, const D, const Comps...> view();
+    template <typename C>
+    EntitySingleView<C> view_mut();
+    template <typename C, typename D, typename... Comps>
+    EntityView<C, D, Comps...> view_mut();
+
+    // Makes all component storage allocate from `allocator`. Must be called before any component is added.
+    void set_allocator(Allocator *allocator);
+
+    ComponentStats component_stats(std::size_t component_id) const;
+    std::size_t component_version(std::size_t component_id) const {
+        return m_component_sets[component_id].as<std::byte>().version();
+    }
+    template <typename C>
+    ComponentStats component_stats() const { return component_stats(C::component_id); }
 
     EntityId entity_count() const { return m_count; }
+    // One past the highest id handed out so far, including reserved ids.
+    EntityId id_bound() const { return m_next_id.load(std::memory_order_relaxed); }
+    std::size_t hierarchy_version() const { return m_hierarchy_version; }
 };
 
 template <typename C, typename... Args>
@@ -125,10 +245,15 @@ void Entity::add(Args &&...args) {
 }
 
 template <typename C>
-C &Entity::get() {
+const C &Entity::get() const {
     return m_manager->get_component<C>(m_id);
 }
 
+template <typename C>
+C &Entity::get_mut() {
+    return m_manager->get_component_mut<C>(m_id);
+}
+
 template <typename C>
 bool Entity::has() const {
     return m_manager->has_component<C>(m_id);
@@ -146,13 +271,17 @@ void Entity::remove() {
 
 template <typename C>
 std::pair<Entity, C *> EntitySingleIterator<C>::operator*() const {
+    if constexpr (!std::is_const_v<C>) {
+        m_set->mark_dirty(m_current_component);
+    }
     return std::make_pair(Entity(*m_current_id, m_manager), m_current_component);
 }
 
 template <typename... Comps>
 EntityIterator<Comps...>::EntityIterator(EntityManager *manager, EntityId current)
     : m_manager(manager), m_current(current) {
-    while (m_current != m_manager->entity_count() && !Entity(m_current, m_manager).has<Comps...>()) {
+    while (m_current != m_manager->id_bound() &&
+           !Entity(m_current, m_manager).has<std::remove_const_t<Comps>...>()) {
         m_current++;
     }
 }
@@ -161,27 +290,39 @@ template <typename... Comps>
 EntityIterator<Comps...> &EntityIterator<Comps...>::operator++() {
     do {
         m_current++;
-    } while (m_current != m_manager->entity_count() && !Entity(m_current, m_manager).has<Comps...>());
+    } while (m_current != m_manager->id_bound() &&
+             !Entity(m_current, m_manager).has<std::remove_const_t<Comps>...>());
     return *this;
 }
 
 template <typename... Comps>
 std::tuple<Entity, Comps *...> EntityIterator<Comps...>::operator*() const {
-    return std::make_tuple(Entity(m_current, m_manager), &m_manager->get_component<Comps>(m_current)...);
+    return std::make_tuple(Entity(m_current, m_manager), component<Comps>()...);
+}
+
+template <typename... Comps>
+template <typename C>
+C *EntityIterator<Comps...>::component() const {
+    if constexpr (std::is_const_v<C>) {
+        return &m_manager->get_component<std::remove_const_t<C>>(m_current);
+    } else {
+        return &m_manager->get_component_mut<C>(m_current);
+    }
 }
 
 template <typename C>
 EntitySingleView<C>::EntitySingleView(EntityManager *manager)
-    : m_manager(manager), m_component_set(manager->m_component_sets[C::component_id].template as<C>()) {}
+    : m_manager(manager),
+      m_component_set(manager->m_component_sets[C::component_id].template as<std::remove_const_t<C>>()) {}
 
 template <typename C>
 EntitySingleIterator<C> EntitySingleView<C>::begin() const {
-    return {m_manager, m_component_set.dense_begin(), m_component_set.storage_begin()};
+    return {m_manager, &m_component_set, m_component_set.dense_begin(), m_component_set.untracked_storage()};
 }
 
 template <typename C>
 EntitySingleIterator<C> EntitySingleView<C>::end() const {
-    return {m_manager, m_component_set.dense_end(), m_component_set.storage_end()};
+    return {m_manager, &m_component_set, m_component_set.dense_end(), m_component_set.storage_end()};
 }
 
 template <typename... Comps>
@@ -191,19 +332,48 @@ EntityIterator<Comps...> EntityView<Comps...>::begin() const {
 
 template <typename... Comps>
 EntityIterator<Comps...> EntityView<Comps...>::end() const {
-    return {m_manager, m_manager->entity_count()};
+    return {m_manager, m_manager->id_bound()};
+}
+
+template <typename C>
+void EntityManager::register_component() {
+    auto &info = m_component_infos[C::component_id];
+    info.size = sizeof(C);
+    info.trivially_copyable = std::is_trivially_copyable_v<C>;
+    info.remove = [](EntityManager &manager, EntityId id) {
+        manager.remove_component<C>(id);
+    };
+    info.assign = [](ComponentSet &set, const EntityId *dense, const void *storage, EntityId size,
+                     const EntityId *sparse, EntityId sparse_size) {
+        set.as<C>().assign(dense, static_cast<const C *>(storage), size, sparse, sparse_size);
+    };
+    info.insert = [](ComponentSet &set, EntityId id, const void *component) {
+        set.as<C>().insert(id, *static_cast<const C *>(component));
+    };
+    info.transfer = [](ComponentSet &from, ComponentSet &to, EntityId id) {
+        to.as<C>().insert(id, std::move(from.as<C>().get_mut(id)));
+        from.as<C>().remove(id);
+    };
 }
 
 template <typename C, typename... Args>
 void EntityManager::add_component(EntityId id, Args &&...args) {
+    if (m_component_infos[C::component_id].remove == nullptr) {
+        register_component<C>();
+    }
     m_component_sets[C::component_id].template as<C>().insert(id, std::forward<Args>(args)...);
 }
 
 template <typename C>
-C &EntityManager::get_component(EntityId id) {
+const C &EntityManager::get_component(EntityId id) {
     return m_component_sets[C::component_id].template as<C>()[id];
 }
 
+template <typename C>
+C &EntityManager::get_component_mut(EntityId id) {
+    return m_component_sets[C::component_id].template as<C>().get_mut(id);
+}
+
 template <typename C>
 bool EntityManager::has_component(EntityId id) {
     return m_component_sets[C::component_id].template as<C>().contains(id);
@@ -214,13 +384,44 @@ void EntityManager::remove_component(EntityId id) {
     m_component_sets[C::component_id].template as<C>().remove(id);
 }
 
+// Reorders the storage of C to follow the order of D, so that iterating both sets in lockstep touches memory
+// linearly. Entities without a D are moved to the end.
+template <typename C, typename D>
+void EntityManager::sort_as() {
+    auto &set = m_component_sets[C::component_id].template as<C>();
+    auto &other = m_component_sets[D::component_id].template as<D>();
+    Vector<EntityId, EntityId> order;
+    order.ensure_capacity(set.size());
+    for (auto *id = other.dense_begin(); id != other.dense_end(); ++id) {
+        if (set.contains(*id)) {
+            order.push(*id);
+        }
+    }
+    for (auto *id = set.dense_begin(); id != set.dense_end(); ++id) {
+        if (!other.contains(*id)) {
+            order.push(*id);
+        }
+    }
+    set.arrange(order);
+}
+
+template <typename C>
+EntitySingleView<const C> EntityManager::view() {
+    return {this};
+}
+
+template <typename C, typename D, typename... Comps>
+EntityView<const C, const D, const Comps...> EntityManager::view() {
+    return {this};
+}
+
 template <typename C>
-EntitySingleView<C> EntityManager::view() {
+EntitySingleView<C> EntityManager::view_mut() {
     return {this};
 }
 
 template <typename C, typename D, typename... Comps>
-EntityView<C, D, Comps...> EntityManager::view() {
+EntityView<C, D, Comps...> EntityManager::view_mut() {
     return {this};
 }
 
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <v2d/support/Array.hh>
+#include <v2d/support/Span.hh>
+#include <v2d/support/TypeErased.hh>
+#include <v2d/support/Vector.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#define V2D_DECLARE_EVENT(name)                                                                                        \
+public:                                                                                                                \
+    static constexpr std::size_t event_id = static_cast<std::size_t>(name)
+
+namespace v2d {
+
+// Double-buffered per-type event channels. Events sent during a frame are appended to a contiguous buffer and become
+// readable as a batch after the next `swap_events`, where they stay until the following swap. Each event is therefore
+// seen exactly once by every reader that runs once per frame, regardless of system order.
+class EventManager {
+    template <typename E>
+    using Buffer = Vector<E>;
+    using Channel = TypeErased<Buffer>;
+    Array<Array<Channel, 2>, 32> m_channels{};
+    std::uint32_t m_write_index{0};
+
+public:
+    template <typename E, typename... Args>
+    E &send_event(Args &&...args);
+    // Events sent during the previous frame.
+    template <typename E>
+    Span<const E> read_events() const;
+
+    // Makes the events sent since the last swap readable and drops the ones that were. Called by `World::update`.
+    void swap_events();
+};
+
+template <typename E, typename... Args>
+E &EventManager::send_event(Args &&...args) {
+    // Stale events are discarded without running destructors.
+    static_assert(std::is_trivially_destructible_v<E>);
+    return m_channels[E::event_id][m_write_index].template as<E>().emplace(std::forward<Args>(args)...);
+}
+
+template <typename E>
+Span<const E> EventManager::read_events() const {
+    return m_channels[E::event_id][m_write_index ^ 1u].template as<E>().span();
+}
+
+inline void EventManager::swap_events() {
+    m_write_index ^= 1u;
+    for (auto &channel : m_channels) {
+        // Keep the capacity so that steady-state frames don't allocate.
+        channel[m_write_index].as<std::byte>().clear();
+    }
+}
+
+} // namespace v2d
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <v2d/core/BuiltinComponents.hh>
+#include <v2d/ecs/Component.hh>
+#include <v2d/ecs/Entity.hh>
+
+#include <cstdint>
+
+namespace v2d {
+
+// Intrusive parent/child links, managed through `Entity::set_parent` and `Entity::remove_parent`. After
+// `EntityManager::sort_hierarchy`, the component set is stored in depth-first pre-order, meaning that every parent
+// precedes its children and every subtree is a contiguous range of the dense array.
+class Hierarchy {
+    V2D_DECLARE_COMPONENT(BuiltinComponents::Hierarchy);
+    friend EntityManager;
+
+private:
+    EntityId m_parent{k_null_entity};
+    EntityId m_first_child{k_null_entity};
+    EntityId m_prev_sibling{k_null_entity};
+    EntityId m_next_sibling{k_null_entity};
+    std::uint32_t m_depth{0};
+
+public:
+    EntityId parent() const { return m_parent; }
+    EntityId first_child() const { return m_first_child; }
+    EntityId next_sibling() const { return m_next_sibling; }
+    std::uint32_t depth() const { return m_depth; }
+    bool is_root() const { return m_parent == k_null_entity; }
+};
+
+} // namespace v2d
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <v2d/ecs/Entity.hh>
+#include <v2d/support/Array.hh>
+#include <v2d/support/Span.hh>
+#include <v2d/support/SparseSet.hh>
+#include <v2d/support/Vector.hh>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace v2d {
+
+// Read-only copy of a component set as of a publish, stable until the reading thread next calls
+// `ComponentPublisher::acquire` for the same component.
+template <typename C>
+class PublishedView {
+    Span<const EntityId, EntityId> m_dense;
+    Span<const EntityId, EntityId> m_sparse;
+    const C *m_storage{nullptr};
+
+public:
+    PublishedView() = default;
+    PublishedView(Span<const EntityId, EntityId> dense, Span<const EntityId, EntityId> sparse, const C *storage)
+        : m_dense(dense), m_sparse(sparse), m_storage(storage) {}
+
+    // The component for `id`, or null if the entity didn't have one.
+    const C *find(EntityId id) const;
+
+    // Dense iteration, in the same order as the source set.
+    EntityId id(EntityId index) const { return m_dense[index]; }
+    const C &operator[](EntityId index) const { return m_storage[index]; }
+    const C *begin() const { return m_storage; }
+    const C *end() const { return m_storage + size(); }
+
+    bool empty() const { return m_dense.size() == 0; }
+    EntityId size() const { return m_dense.size(); }
+};
+
+// Publishes copies of selected component sets so that another thread, typically the render thread, can read the
+// state of the last frame while the simulation writes the next one. Each published set is triple buffered: the
+// simulation fills a back buffer and exchanges it with the latest one, and the reader exchanges its buffer for the
+// latest one if a newer publish happened, so neither side ever waits for the other or sees a partial frame. Each
+// buffer remembers the set's write epoch from when it was last filled, and publishing into it only copies the storage
+// pages written since then; the dense and sparse arrays, and the rest of storage, are only copied when entities were
+// added or removed since that buffer was last written. Only trivially copyable components can be published.
+class ComponentPublisher {
+    struct Buffer {
+        Vector<EntityId, EntityId> dense;
+        Vector<EntityId, EntityId> sparse;
+        Vector<std::byte, std::size_t, SparseSet<std::byte, EntityId>::k_storage_alignment> storage;
+        std::size_t version{~std::size_t(0)};
+        std::size_t synced_epoch{0};
+    };
+    struct PublishedSet {
+        Array<Buffer, 3> buffers;
+        std::uint8_t write_index{0};
+        std::uint8_t read_index{1};
+        // Index of the latest buffer, with `k_fresh` set if the reader hasn't taken it yet.
+        std::atomic<std::uint8_t> latest{2};
+    };
+    static constexpr std::uint8_t k_fresh = 4;
+
+    Array<std::unique_ptr<PublishedSet>, 16> m_sets{};
+
+    const Buffer &acquire(std::size_t component_id);
+
+public:
+    template <typename C>
+    void enable();
+    // Called on the simulation thread at frame boundaries, which `World::update` does.
+    // Advances the sets' write epochs, so it needs mutable access.
+    void publish(EntityManager &manager);
+    // Called on the reading thread. Returns the most recently published copy.
+    template <typename C>
+    PublishedView<C> acquire();
+};
+
+template <typename C>
+const C *PublishedView<C>::find(EntityId id) const {
+    if (id >= m_sparse.size()) {
+        return nullptr;
+    }
+    const auto index = m_sparse[id];
+    return index < m_dense.size() && m_dense[index] == id ? m_storage + index : nullptr;
+}
+
+template <typename C>
+void ComponentPublisher::enable() {
+    static_assert(std::is_trivially_copyable_v<C>);
+    static_assert(alignof(C) <= SparseSet<C, EntityId>::k_storage_alignment);
+    if (!m_sets[C::component_id]) {
+        m_sets[C::component_id] = std::make_unique<PublishedSet>();
+    }
+}
+
+template <typename C>
+PublishedView<C> ComponentPublisher::acquire() {
+    const auto &buffer = acquire(C::component_id);
+    return {{buffer.dense.data(), buffer.dense.size()},
+            {buffer.sparse.data(), buffer.sparse.size()},
+            reinterpret_cast<const C *>(buffer.storage.data())};
+}
+
+} // namespace v2d
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <v2d/support/Array.hh>
+#include <v2d/support/Assert.hh>
+
+#include <cstddef>
+#include <utility>
+
+#define V2D_DECLARE_RESOURCE(name)                                                                                     \
+public:                                                                                                                \
+    static constexpr std::size_t resource_id = static_cast<std::size_t>(name)
+
+namespace v2d {
+
+// Owns at most one instance of each resource type, for world-wide state such as the camera or input that doesn't
+// belong to any particular entity. Like components, resources are identified by a small explicit id, so access is a
+// single array index.
+class ResourceManager {
+    struct Slot {
+        void *resource{nullptr};
+        void (*destroy)(void *){nullptr};
+    };
+    Array<Slot, 32> m_resources{};
+
+public:
+    ResourceManager() = default;
+    ResourceManager(const ResourceManager &) = delete;
+    ResourceManager(ResourceManager &&) = delete;
+    ~ResourceManager();
+
+    ResourceManager &operator=(const ResourceManager &) = delete;
+    ResourceManager &operator=(ResourceManager &&) = delete;
+
+    // Constructs the resource in place, replacing any existing instance.
+    template <typename R, typename... Args>
+    R &set_resource(Args &&...args);
+    template <typename R>
+    void remove_resource();
+
+    template <typename R>
+    R &resource();
+    template <typename R>
+    const R &resource() const;
+    template <typename R>
+    bool has_resource() const;
+};
+
+inline ResourceManager::~ResourceManager() {
+    for (auto &slot : m_resources) {
+        if (slot.resource != nullptr) {
+            slot.destroy(slot.resource);
+        }
+    }
+}
+
+template <typename R, typename... Args>
+R &ResourceManager::set_resource(Args &&...args) {
+    remove_resource<R>();
+    auto *resource = new R(std::forward<Args>(args)...);
+    m_resources[R::resource_id] = {
+        .resource = resource,
+        .destroy =
+            [](void *ptr) {
+                delete static_cast<R *>(ptr);
+            },
+    };
+    return *resource;
+}
+
+template <typename R>
+void ResourceManager::remove_resource() {
+    auto &slot = m_resources[R::resource_id];
+    if (slot.resource != nullptr) {
+        slot.destroy(std::exchange(slot.resource, nullptr));
+    }
+}
+
+template <typename R>
+R &ResourceManager::resource() {
+    V2D_ASSERT(has_resource<R>());
+    return *static_cast<R *>(m_resources[R::resource_id].resource);
+}
+
+template <typename R>
+const R &ResourceManager::resource() const {
+    V2D_ASSERT(has_resource<R>());
+    return *static_cast<const R *>(m_resources[R::resource_id].resource);
+}
+
+template <typename R>
+bool ResourceManager::has_resource() const {
+    return m_resources[R::resource_id].resource != nullptr;
+}
+
+} // namespace v2d
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <v2d/ecs/Entity.hh>
+#include <v2d/support/Array.hh>
+#include <v2d/support/Span.hh>
+#include <v2d/support/Vector.hh>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace v2d {
+
+// In-memory snapshot of the component sets of an `EntityManager`, intended to be captured every tick and restored on
+// rollback. Buffers are kept between captures. The dense and sparse arrays are only copied when the set's version
+// shows that entities were added or removed, and only the storage pages written since the last capture or restore are
+// copied, so a tick which touches a small part of the world costs a small amount to capture and to roll back. Managers
+// with components that aren't trivially copyable can't be snapshotted.
+class WorldSnapshot {
+    struct Block {
+        Vector<std::byte, std::size_t, SparseSet<std::byte, EntityId>::k_storage_alignment> bytes;
+        std::size_t size{0};
+    };
+    struct SetSnapshot {
+        Block dense;
+        Block sparse;
+        Block storage;
+        EntityId size{0};
+        EntityId sparse_size{0};
+        std::size_t version{0};
+        // The set's write epoch when the snapshot was last in sync with it.
+        std::size_t synced_epoch{0};
+        bool captured{false};
+    };
+
+    const EntityManager *m_source{nullptr};
+    Array<SetSnapshot, 16> m_sets{};
+    EntityId m_count{0};
+    EntityId m_next_id{0};
+    bool m_hierarchy_dirty{false};
+    std::size_t m_written_pages{0};
+
+public:
+    static constexpr std::size_t k_page_size = SparseSet<std::byte, EntityId>::k_page_size;
+
+    // Both return false, without changing anything, if the manager has a component type which isn't trivially
+    // copyable or has hibernated entities. Capturing advances the sets' write epochs, so it needs mutable access.
+    bool capture(EntityManager &manager);
+    bool restore(EntityManager &manager);
+
+    // Delta encoding for replays and replication. `encode_diff` appends the changes needed to turn this snapshot into
+    // the current state of `manager`: per component set, the removed entities and the added or modified components,
+    // with each component stored as the XOR against its previous value so that unchanged bytes collapse into
+    // varint-encoded zero runs. `apply_diff` applies such a diff to a manager in the state the snapshot was taken in,
+    // returning false without changing anything if the diff is malformed or doesn't match the registered components.
+    // Diffs can't include hibernated entities, so `apply_diff` also returns false if the manager has any, and
+    // `encode_diff` asserts it has none.
+    void encode_diff(const EntityManager &manager, LargeVector<std::uint8_t> &diff) const;
+    static bool apply_diff(EntityManager &manager, LargeSpan<const std::uint8_t> diff);
+
+    // The number of pages written by the last capture or restore.
+    std::size_t written_pages() const { return m_written_pages; }
+};
+
+} // namespace v2d
@@ -1,14 +1,65 @@
 #pragma once
 
+#include <v2d/support/Array.hh>
 #include <v2d/support/Vector.hh>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace v2d {
 
+class SystemManager;
 struct World;
 
+struct SystemStats {
+    const char *name;
+    float min_ms;
+    float average_ms;
+    float p99_ms;
+    std::size_t entity_count;
+    std::size_t allocation_count;
+};
+
 struct System {
+    friend SystemManager;
+    friend World;
+
+private:
+    // Rolling window of timings, only recorded whilst profiling is enabled.
+    struct Profile {
+        static constexpr std::uint32_t k_sample_count = 128;
+        Array<float, k_sample_count> samples{};
+        std::uint32_t next_sample{0};
+        std::uint32_t sample_count{0};
+        std::size_t entity_count{0};
+        std::size_t last_entity_count{0};
+        std::size_t last_allocation_count{0};
+
+        void record(float ms, std::size_t allocation_count);
+    };
+    Profile m_profile;
+
+    // Run criteria, evaluated by `World::update` each time the system is eligible to run.
+    struct Schedule {
+        static constexpr std::uint32_t k_unassigned_phase = 0xffffffffu;
+        std::uint32_t interval{1};
+        std::uint32_t phase{k_unassigned_phase};
+        std::uint32_t counter{0};
+        float period{0.0f};
+        float elapsed{0.0f};
+        std::size_t watched_version{0};
+        std::uint16_t watched_components{0};
+        bool enabled{true};
+    };
+    Schedule m_schedule;
+    bool m_fixed{false};
+
+protected:
+    // Reports the number of entities processed by the current update to the profiler.
+    void count_entities(std::size_t count) { m_profile.entity_count += count; }
+
+public:
     System() = default;
     System(const System &) = delete;
     System(System &&) = delete;
@@ -18,17 +69,55 @@ struct System {
     System &operator=(System &&) = delete;
 
     virtual void update(World *world, float dt) = 0;
+    virtual const char *name() const { return "System"; }
+
+    // Only run every `ticks` frames (or fixed steps for fixed systems). Systems with the same interval are given
+    // different phases so that their updates are spread across frames. `dt` is the time since the last update.
+    System &run_every(std::uint32_t ticks);
+    // Only run once at least 1 / `hz` seconds have passed since the last update.
+    System &run_at(float hz);
+    // Only run when entities have been added to or removed from any of the given component sets since the last
+    // update. Changes to component values aren't tracked.
+    template <typename... Comps>
+    System &run_on_change();
+
+    void set_enabled(bool enabled) { m_schedule.enabled = enabled; }
+    bool enabled() const { return m_schedule.enabled; }
 };
 
+template <typename... Comps>
+System &System::run_on_change() {
+    m_schedule.watched_components |= ((1u << Comps::component_id) | ...);
+    m_schedule.watched_version = ~std::size_t(0);
+    return *this;
+}
+
 class SystemManager {
 protected:
     Vector<std::unique_ptr<System>> m_systems;
+    bool m_profiling{false};
 
 public:
+    // Adds a system which is updated once per `World::update` call, i.e. once per rendered frame.
+    template <typename S, typename... Args>
+    S &add(Args &&...args) {
+        return static_cast<S &>(*m_systems.emplace(new S(std::forward<Args>(args)...)));
+    }
+
+    // Adds a system which is updated at the world's fixed timestep, zero or more times per `World::update` call.
     template <typename S, typename... Args>
-    void add(Args &&...args) {
-        m_systems.emplace(new S(std::forward<Args>(args)...));
+    S &add_fixed(Args &&...args) {
+        auto &system = add<S>(std::forward<Args>(args)...);
+        system.m_fixed = true;
+        return system;
     }
+
+    void set_profiling(bool profiling);
+    SystemStats system_stats(std::uint32_t index) const;
+    void dump_profile() const;
+
+    bool profiling() const { return m_profiling; }
+    std::uint32_t system_count() const { return m_systems.size(); }
 };
 
 } // namespace v2d
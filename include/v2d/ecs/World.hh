@@ -1,12 +1,41 @@
 #pragma once
 
 #include <v2d/ecs/Entity.hh>
+#include <v2d/ecs/Event.hh>
+#include <v2d/ecs/Publisher.hh>
+#include <v2d/ecs/Resource.hh>
 #include <v2d/ecs/System.hh>
+#include <v2d/support/FrameArena.hh>
+
+#include <cstdint>
 
 namespace v2d {
 
-struct World : public EntityManager, public SystemManager {
+struct World : public EntityManager, public ResourceManager, public EventManager, public SystemManager {
+private:
+    float m_fixed_timestep{1.0f / 60.0f};
+    float m_accumulator{0.0f};
+    std::uint32_t m_max_fixed_steps{8};
+    std::uint32_t m_next_phase{0};
+    ComponentPublisher m_publisher;
+    FrameArena m_frame_arena;
+
+    bool should_run(System &system, float &dt);
+    void run_system(System &system, float dt);
+
+public:
+    // Runs as many fixed steps as have accumulated, up to `max_steps`, followed by the per-frame systems. If the
+    // simulation falls further behind than that, the backlog is dropped rather than letting it grow without bound.
+    // Events sent during the update are readable during the next one, published components are published at the end,
+    // and the frame arena is reset.
     void update(float dt);
+    void set_fixed_timestep(float timestep, std::uint32_t max_steps);
+
+    ComponentPublisher &publisher() { return m_publisher; }
+    FrameArena &frame_arena() { return m_frame_arena; }
+    float fixed_timestep() const { return m_fixed_timestep; }
+    // How far between the last and next fixed step the current frame is, in [0, 1), for interpolating rendering.
+    float interpolation_alpha() const { return m_accumulator / m_fixed_timestep; }
 };
 
 } // namespace v2d
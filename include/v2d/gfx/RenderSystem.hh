@@ -18,6 +18,7 @@ public:
         : m_context(context), m_descriptor_set(descriptor_set) {}
 
     void update(World *world, float dt) override;
+    const char *name() const override { return "RenderSystem"; }
 };
 
 } // namespace v2d
@@ -45,10 +45,10 @@ public:
         return *this;
     }
 
-    Vec operator+(const Vec &rhs) { return Vec(*this) += rhs; }
-    Vec operator-(const Vec &rhs) { return Vec(*this) -= rhs; }
-    Vec operator*(const Vec &rhs) { return Vec(*this) *= rhs; }
-    Vec operator/(const Vec &rhs) { return Vec(*this) /= rhs; }
+    Vec operator+(const Vec &rhs) const { return Vec(*this) += rhs; }
+    Vec operator-(const Vec &rhs) const { return Vec(*this) -= rhs; }
+    Vec operator*(const Vec &rhs) const { return Vec(*this) *= rhs; }
+    Vec operator/(const Vec &rhs) const { return Vec(*this) /= rhs; }
 
     constexpr T x() const requires(ElementCount >= 1) { return m_elements[0]; }
     constexpr T y() const requires(ElementCount >= 2) { return m_elements[1]; }
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+
+namespace v2d {
+
+// Polymorphic source of memory for containers. Deallocation isn't given the size of the allocation, since type-erased
+// containers may free a buffer under a different element type than it was allocated with.
+class Allocator {
+public:
+    virtual void *allocate(std::size_t size, std::size_t alignment) = 0;
+    virtual void deallocate(void *ptr) = 0;
+    // Resizes an allocation, preserving its first `used_size` bytes, possibly moving it. The default allocates a new
+    // block and copies.
+    virtual void *reallocate(void *ptr, std::size_t used_size, std::size_t size, std::size_t alignment);
+
+protected:
+    Allocator() = default;
+    Allocator(const Allocator &) = default;
+    Allocator(Allocator &&) = default;
+    ~Allocator() = default;
+
+    Allocator &operator=(const Allocator &) = default;
+    Allocator &operator=(Allocator &&) = default;
+};
+
+// The global heap, used by containers which haven't been given an allocator. Allocations of at least
+// `k_mapping_threshold` bytes get their own anonymous mapping, so that growing them can remap the pages with mremap
+// instead of copying and touching every page.
+class HeapAllocator final : public Allocator {
+public:
+    static constexpr std::size_t k_mapping_threshold = 1024 * 1024;
+
+    void *allocate(std::size_t size, std::size_t alignment) override;
+    void deallocate(void *ptr) override;
+    void *reallocate(void *ptr, std::size_t used_size, std::size_t size, std::size_t alignment) override;
+};
+
+// Backs large allocations with 2 MiB pages, so that random access over big arrays such as sparse sets needs far fewer
+// TLB entries. `Transparent` asks for transparent huge pages with madvise, which may or may not be granted, and
+// `Explicit` maps from the preallocated hugetlbfs pool, falling back to transparent huge pages if the pool is empty.
+// Allocations below `k_huge_threshold` come from the heap. A world can opt in with `EntityManager::set_allocator`.
+class HugePageAllocator final : public Allocator {
+public:
+    enum class Mode {
+        Transparent,
+        Explicit,
+    };
+    static constexpr std::size_t k_huge_page_size = 2 * 1024 * 1024;
+    static constexpr std::size_t k_huge_threshold = k_huge_page_size / 2;
+
+private:
+    Mode m_mode;
+
+public:
+    explicit HugePageAllocator(Mode mode = Mode::Transparent) : m_mode(mode) {}
+
+    void *allocate(std::size_t size, std::size_t alignment) override;
+    void deallocate(void *ptr) override;
+    void *reallocate(void *ptr, std::size_t used_size, std::size_t size, std::size_t alignment) override;
+};
+
+Allocator &heap_allocator();
+
+} // namespace v2d
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <v2d/support/Assert.hh>
+#include <v2d/support/Span.hh>
+#include <v2d/support/Vector.hh>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace v2d {
+
+// Word-parallel kernels over arrays of 64-bit words, used by `Bitset`. They use AVX2 when the CPU supports it, chosen
+// at runtime so that the rest of the build doesn't need to target AVX2.
+void and_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t count);
+void or_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t count);
+void and_not_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t count);
+std::size_t popcount_words(const std::uint64_t *words, std::size_t count);
+
+// Dynamically sized set of bits, e.g. a component mask indexed by entity id. Bits past `size` are always zero.
+template <typename SizeType = std::uint32_t>
+class Bitset {
+    static constexpr SizeType k_word_bits = 64;
+
+    // Aligned for the vector kernels.
+    Vector<std::uint64_t, SizeType, 32> m_words;
+    SizeType m_size{0};
+
+    static SizeType word_count(SizeType bits) { return (bits + k_word_bits - 1) / k_word_bits; }
+
+public:
+    class Iterator {
+        const Bitset *m_bitset;
+        SizeType m_index;
+
+    public:
+        Iterator(const Bitset *bitset, SizeType index) : m_bitset(bitset), m_index(index) {}
+
+        Iterator &operator++() {
+            m_index = m_bitset->find_next(m_index + 1);
+            return *this;
+        }
+        bool operator==(const Iterator &other) const { return m_index == other.m_index; }
+        SizeType operator*() const { return m_index; }
+    };
+
+    Bitset() = default;
+    explicit Bitset(SizeType size) { ensure_size(size); }
+
+    // Grows the bitset to at least `size` bits, with the new bits cleared.
+    void ensure_size(SizeType size);
+    void clear();
+
+    void set(SizeType index);
+    void reset(SizeType index);
+    bool test(SizeType index) const;
+
+    // In-place set operations. Bits past the end of `other` count as clear.
+    Bitset &operator&=(const Bitset &other);
+    Bitset &operator|=(const Bitset &other);
+    Bitset &and_not(const Bitset &other);
+
+    // The index of the first set bit at or after `index`, or `size()` if there is none.
+    SizeType find_next(SizeType index) const;
+    SizeType count() const { return static_cast<SizeType>(popcount_words(m_words.data(), m_words.size())); }
+    bool any() const { return find_next(0) != m_size; }
+    bool none() const { return !any(); }
+
+    // Iterates over the indices of the set bits.
+    Iterator begin() const { return {this, find_next(0)}; }
+    Iterator end() const { return {this, m_size}; }
+
+    Span<std::uint64_t, SizeType> words() { return {m_words.data(), m_words.size()}; }
+    Span<const std::uint64_t, SizeType> words() const { return {m_words.data(), m_words.size()}; }
+    SizeType size() const { return m_size; }
+};
+
+using LargeBitset = Bitset<std::size_t>;
+
+template <typename SizeType>
+void Bitset<SizeType>::ensure_size(SizeType size) {
+    if (size > m_size) {
+        m_words.ensure_size(word_count(size));
+        m_size = size;
+    }
+}
+
+template <typename SizeType>
+void Bitset<SizeType>::clear() {
+    std::fill(m_words.begin(), m_words.end(), 0);
+}
+
+template <typename SizeType>
+void Bitset<SizeType>::set(SizeType index) {
+    V2D_ASSERT(index < m_size);
+    m_words[index / k_word_bits] |= std::uint64_t(1) << (index % k_word_bits);
+}
+
+template <typename SizeType>
+void Bitset<SizeType>::reset(SizeType index) {
+    V2D_ASSERT(index < m_size);
+    m_words[index / k_word_bits] &= ~(std::uint64_t(1) << (index % k_word_bits));
+}
+
+template <typename SizeType>
+bool Bitset<SizeType>::test(SizeType index) const {
+    V2D_ASSERT(index < m_size);
+    return ((m_words[index / k_word_bits] >> (index % k_word_bits)) & 1) != 0;
+}
+
+template <typename SizeType>
+Bitset<SizeType> &Bitset<SizeType>::operator&=(const Bitset &other) {
+    const auto common = std::min(m_words.size(), other.m_words.size());
+    and_words(m_words.data(), other.m_words.data(), common);
+    std::fill(m_words.begin() + common, m_words.end(), 0);
+    return *this;
+}
+
+template <typename SizeType>
+Bitset<SizeType> &Bitset<SizeType>::operator|=(const Bitset &other) {
+    ensure_size(other.m_size);
+    or_words(m_words.data(), other.m_words.data(), other.m_words.size());
+    return *this;
+}
+
+template <typename SizeType>
+Bitset<SizeType> &Bitset<SizeType>::and_not(const Bitset &other) {
+    and_not_words(m_words.data(), other.m_words.data(), std::min(m_words.size(), other.m_words.size()));
+    return *this;
+}
+
+template <typename SizeType>
+SizeType Bitset<SizeType>::find_next(SizeType index) const {
+    if (index >= m_size) {
+        return m_size;
+    }
+    auto word_index = index / k_word_bits;
+    // Mask off the bits below `index` in the first word, then skip whole zero words.
+    auto word = m_words[word_index] & (~std::uint64_t(0) << (index % k_word_bits));
+    while (word == 0) {
+        if (++word_index == m_words.size()) {
+            return m_size;
+        }
+        word = m_words[word_index];
+    }
+    return word_index * k_word_bits + static_cast<SizeType>(std::countr_zero(word));
+}
+
+} // namespace v2d
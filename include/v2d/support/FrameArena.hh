@@ -0,0 +1,88 @@
+#pragma once
+
+#include <v2d/support/Allocator.hh>
+#include <v2d/support/Span.hh>
+#include <v2d/support/Vector.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace v2d {
+
+// Single-threaded bump allocator. Deallocation is a no-op and `reset` rewinds to the first block in O(1), keeping all
+// blocks for reuse, so after the first few frames it never touches the heap.
+class LinearArena final : public Allocator {
+    struct Block {
+        std::byte *data;
+        std::size_t size;
+    };
+    Vector<Block> m_blocks;
+    std::uint32_t m_block_index{0};
+    std::size_t m_offset{0};
+    std::size_t m_block_size;
+
+public:
+    explicit LinearArena(std::size_t block_size) : m_block_size(block_size) {}
+    LinearArena(const LinearArena &) = delete;
+    LinearArena(LinearArena &&) = delete;
+    ~LinearArena();
+
+    LinearArena &operator=(const LinearArena &) = delete;
+    LinearArena &operator=(LinearArena &&) = delete;
+
+    void *allocate(std::size_t size, std::size_t alignment) override;
+    void deallocate(void *) override {}
+    void reset();
+
+    // The total size of all blocks owned by the arena.
+    std::size_t reserved_bytes() const;
+};
+
+// Memory for transient data which lives until the end of the frame, such as visibility or command lists. Every thread
+// allocates from its own sub-arena, which only takes a lock on the thread's first allocation of the frame. `reset`
+// releases everything at once and must only be called when no other thread is using the arena, which `World::update`
+// does at the end of every frame. Containers built from the arena must not be used after the reset that follows.
+class FrameArena {
+    std::size_t m_block_size;
+    std::uint64_t m_id;
+    std::mutex m_mutex;
+    Vector<std::unique_ptr<LinearArena>> m_arenas;
+    std::uint32_t m_used_arenas{0};
+
+    LinearArena &acquire_local();
+
+public:
+    static constexpr std::size_t k_default_block_size = 256 * 1024;
+
+    explicit FrameArena(std::size_t block_size = k_default_block_size);
+
+    // The calling thread's sub-arena.
+    LinearArena &local();
+    void reset();
+
+    template <typename T>
+    Vector<T> vector() {
+        return Vector<T>(local());
+    }
+    template <typename T>
+    Span<T> allocate_span(std::uint32_t count);
+
+    std::size_t reserved_bytes();
+};
+
+template <typename T>
+Span<T> FrameArena::allocate_span(std::uint32_t count) {
+    // Arena memory is never destructed.
+    static_assert(std::is_trivially_destructible_v<T>);
+    auto *data = static_cast<T *>(local().allocate(count * sizeof(T), alignof(T)));
+    for (std::uint32_t i = 0; i < count; i++) {
+        new (data + i) T();
+    }
+    return {data, count};
+}
+
+} // namespace v2d
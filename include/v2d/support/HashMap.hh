@@ -0,0 +1,322 @@
+#pragma once
+
+#include <v2d/support/Allocator.hh>
+#include <v2d/support/Array.hh>
+#include <v2d/support/Assert.hh>
+#include <v2d/support/Vector.hh>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace v2d {
+
+// Flat open-addressing hash map in the style of Swiss tables. Every slot has a control byte which is either empty,
+// deleted, or the low 7 bits of the key's hash. Lookups probe groups of 16 control bytes at a time, comparing all of
+// them against the hash in a couple of SIMD instructions, and only compare keys for the few slots that match. Entries
+// are stored inline, so pointers to them are invalidated by any insertion which grows the table.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class HashMap {
+public:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+private:
+    static constexpr std::uint32_t k_group_size = 16;
+    static constexpr std::uint8_t k_empty = 0x80;
+    static constexpr std::uint8_t k_deleted = 0xfe;
+
+    struct alignas(Entry) Slot {
+        Array<std::byte, sizeof(Entry)> bytes;
+    };
+
+    // Bit i is set if the i-th control byte of the group matches.
+    class Group {
+#if defined(__SSE2__)
+        __m128i m_control;
+
+    public:
+        explicit Group(const std::uint8_t *control)
+            : m_control(_mm_loadu_si128(reinterpret_cast<const __m128i *>(control))) {}
+
+        std::uint32_t match(std::uint8_t h2) const {
+            return static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(m_control, _mm_set1_epi8(static_cast<char>(h2)))));
+        }
+        std::uint32_t match_empty() const { return match(k_empty); }
+        // Empty and deleted are the only control bytes with the high bit set.
+        std::uint32_t match_free() const { return static_cast<std::uint32_t>(_mm_movemask_epi8(m_control)); }
+#else
+        Array<std::uint8_t, k_group_size> m_control;
+
+    public:
+        explicit Group(const std::uint8_t *control) { std::memcpy(m_control.data(), control, k_group_size); }
+
+        std::uint32_t match(std::uint8_t h2) const {
+            std::uint32_t mask = 0;
+            for (std::uint32_t i = 0; i < k_group_size; i++) {
+                mask |= static_cast<std::uint32_t>(m_control[i] == h2) << i;
+            }
+            return mask;
+        }
+        std::uint32_t match_empty() const { return match(k_empty); }
+        std::uint32_t match_free() const {
+            std::uint32_t mask = 0;
+            for (std::uint32_t i = 0; i < k_group_size; i++) {
+                mask |= static_cast<std::uint32_t>(m_control[i] >> 7) << i;
+            }
+            return mask;
+        }
+#endif
+    };
+
+    // The control bytes are followed by a copy of the first group, so that a group can be loaded from any slot without
+    // wrapping around.
+    Vector<std::uint8_t> m_control;
+    Vector<Slot> m_slots;
+    std::uint32_t m_size{0};
+    // Insertions left until the table is 7/8 full, counting deleted slots as full.
+    std::uint32_t m_growth_left{0};
+
+    static std::size_t hash(const K &key) {
+        // std::hash is the identity for integers, so mix the bits to spread both the group index and the control byte.
+        std::uint64_t h = static_cast<std::uint64_t>(Hash{}(key)) * 0x9e3779b97f4a7c15ull;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+    static std::uint8_t h2(std::size_t hash) { return static_cast<std::uint8_t>(hash & 0x7f); }
+
+    std::uint32_t mask() const { return m_slots.size() - 1; }
+    Entry &entry(std::uint32_t index) { return *std::launder(reinterpret_cast<Entry *>(&m_slots[index])); }
+    const Entry &entry(std::uint32_t index) const {
+        return *std::launder(reinterpret_cast<const Entry *>(&m_slots[index]));
+    }
+    void set_control(std::uint32_t index, std::uint8_t control);
+
+    std::uint32_t find_index(const K &key) const;
+    std::uint32_t find_free(std::size_t hash) const;
+    void rehash(std::uint32_t capacity);
+
+public:
+    static constexpr std::uint32_t k_npos = 0xffffffffu;
+
+    class Iterator {
+        HashMap *m_map;
+        std::uint32_t m_index;
+
+        void skip_free() {
+            while (m_index < m_map->m_slots.size() && m_map->m_control[m_index] >= k_empty) {
+                m_index++;
+            }
+        }
+
+    public:
+        Iterator(HashMap *map, std::uint32_t index) : m_map(map), m_index(index) { skip_free(); }
+
+        Iterator &operator++() {
+            m_index++;
+            skip_free();
+            return *this;
+        }
+        bool operator==(const Iterator &other) const { return m_index == other.m_index; }
+        Entry &operator*() const { return m_map->entry(m_index); }
+        Entry *operator->() const { return &m_map->entry(m_index); }
+    };
+
+    HashMap() = default;
+    explicit HashMap(Allocator &allocator) {
+        m_control.set_allocator(&allocator);
+        m_slots.set_allocator(&allocator);
+    }
+    HashMap(const HashMap &) = delete;
+    HashMap(HashMap &&other) noexcept
+        : m_control(std::move(other.m_control)), m_slots(std::move(other.m_slots)),
+          m_size(std::exchange(other.m_size, 0u)), m_growth_left(std::exchange(other.m_growth_left, 0u)) {}
+    ~HashMap() { clear(); }
+
+    HashMap &operator=(const HashMap &) = delete;
+    HashMap &operator=(HashMap &&) = delete;
+
+    // Inserts the value if the key isn't already present, returning the entry and whether it was inserted.
+    template <typename... Args>
+    std::pair<Entry *, bool> emplace(const K &key, Args &&...args);
+    V &operator[](const K &key) { return emplace(key).first->value; }
+    bool remove(const K &key);
+    void clear();
+    // Makes room for `capacity` entries without further rehashing.
+    void ensure_capacity(std::uint32_t capacity);
+
+    V *find(const K &key);
+    const V *find(const K &key) const;
+    bool contains(const K &key) const { return find_index(key) != k_npos; }
+
+    Iterator begin() { return {this, 0}; }
+    Iterator end() { return {this, m_slots.size()}; }
+
+    bool empty() const { return m_size == 0; }
+    std::uint32_t size() const { return m_size; }
+    std::uint32_t capacity() const { return m_slots.size(); }
+};
+
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::set_control(std::uint32_t index, std::uint8_t control) {
+    m_control[index] = control;
+    if (index < k_group_size) {
+        m_control[m_slots.size() + index] = control;
+    }
+}
+
+template <typename K, typename V, typename Hash>
+std::uint32_t HashMap<K, V, Hash>::find_index(const K &key) const {
+    if (m_size == 0) {
+        return k_npos;
+    }
+    const auto key_hash = hash(key);
+    auto position = static_cast<std::uint32_t>(key_hash >> 7) & mask();
+    for (std::uint32_t step = k_group_size;; step += k_group_size) {
+        const Group group(m_control.data() + position);
+        for (auto matches = group.match(h2(key_hash)); matches != 0; matches &= matches - 1) {
+            const auto index = (position + static_cast<std::uint32_t>(std::countr_zero(matches))) & mask();
+            if (entry(index).key == key) {
+                return index;
+            }
+        }
+        if (group.match_empty() != 0) {
+            return k_npos;
+        }
+        // Triangular probing visits every group when the group count is a power of two.
+        position = (position + step) & mask();
+    }
+}
+
+template <typename K, typename V, typename Hash>
+std::uint32_t HashMap<K, V, Hash>::find_free(std::size_t hash) const {
+    auto position = static_cast<std::uint32_t>(hash >> 7) & mask();
+    for (std::uint32_t step = k_group_size;; step += k_group_size) {
+        if (const auto free = Group(m_control.data() + position).match_free(); free != 0) {
+            return (position + static_cast<std::uint32_t>(std::countr_zero(free))) & mask();
+        }
+        position = (position + step) & mask();
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::rehash(std::uint32_t capacity) {
+    V2D_ASSERT(std::has_single_bit(capacity) && capacity >= k_group_size);
+    Vector<std::uint8_t> old_control(std::move(m_control));
+    Vector<Slot> old_slots(std::move(m_slots));
+    m_control = Vector<std::uint8_t>(old_control.allocator());
+    m_slots = Vector<Slot>(old_slots.allocator());
+    m_control.ensure_size(capacity + k_group_size, k_empty);
+    m_slots.ensure_size(capacity);
+    m_growth_left = capacity - capacity / 8 - m_size;
+
+    for (std::uint32_t i = 0; i < old_slots.size(); i++) {
+        if (old_control[i] >= k_empty) {
+            continue;
+        }
+        auto &old = *std::launder(reinterpret_cast<Entry *>(&old_slots[i]));
+        const auto key_hash = hash(old.key);
+        const auto index = find_free(key_hash);
+        set_control(index, h2(key_hash));
+        new (&m_slots[index]) Entry(std::move(old));
+        old.~Entry();
+    }
+}
+
+template <typename K, typename V, typename Hash>
+template <typename... Args>
+std::pair<typename HashMap<K, V, Hash>::Entry *, bool> HashMap<K, V, Hash>::emplace(const K &key, Args &&...args) {
+    if (const auto index = find_index(key); index != k_npos) {
+        return {&entry(index), false};
+    }
+    if (m_slots.empty()) {
+        rehash(k_group_size);
+    }
+    const auto key_hash = hash(key);
+    auto index = find_free(key_hash);
+    if (m_growth_left == 0 && m_control[index] == k_empty) {
+        // Rehash in place if most of the load is tombstones, otherwise grow.
+        rehash(m_size * 2 < m_slots.size() - m_slots.size() / 8 ? m_slots.size() : m_slots.size() * 2);
+        index = find_free(key_hash);
+    }
+    if (m_control[index] == k_empty) {
+        m_growth_left--;
+    }
+    set_control(index, h2(key_hash));
+    m_size++;
+    return {new (&m_slots[index]) Entry{key, V(std::forward<Args>(args)...)}, true};
+}
+
+template <typename K, typename V, typename Hash>
+bool HashMap<K, V, Hash>::remove(const K &key) {
+    const auto index = find_index(key);
+    if (index == k_npos) {
+        return false;
+    }
+    entry(index).~Entry();
+    m_size--;
+
+    // If no probe sequence could have passed over this slot while it was full, it can go straight back to empty rather
+    // than needing a tombstone. That is the case when there is an empty slot within a group's width on both sides.
+    const auto after = Group(m_control.data() + index).match_empty();
+    const auto before = Group(m_control.data() + ((index - k_group_size) & mask())).match_empty();
+    const auto gap = static_cast<std::uint32_t>(std::countr_zero(after)) +
+                     static_cast<std::uint32_t>(std::countl_zero(before << 16));
+    if (after != 0 && before != 0 && gap < k_group_size) {
+        set_control(index, k_empty);
+        m_growth_left++;
+    } else {
+        set_control(index, k_deleted);
+    }
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::clear() {
+    if constexpr (!std::is_trivially_destructible_v<Entry>) {
+        for (std::uint32_t i = 0; i < m_slots.size(); i++) {
+            if (m_control[i] < k_empty) {
+                entry(i).~Entry();
+            }
+        }
+    }
+    if (!m_control.empty()) {
+        std::memset(m_control.data(), k_empty, m_control.size());
+    }
+    m_size = 0;
+    m_growth_left = m_slots.size() - m_slots.size() / 8;
+}
+
+template <typename K, typename V, typename Hash>
+void HashMap<K, V, Hash>::ensure_capacity(std::uint32_t capacity) {
+    // Keep the load factor at or below 7/8.
+    const auto required = std::bit_ceil(std::max(capacity + capacity / 7, k_group_size));
+    if (required > m_slots.size()) {
+        rehash(required);
+    }
+}
+
+template <typename K, typename V, typename Hash>
+V *HashMap<K, V, Hash>::find(const K &key) {
+    const auto index = find_index(key);
+    return index != k_npos ? &entry(index).value : nullptr;
+}
+
+template <typename K, typename V, typename Hash>
+const V *HashMap<K, V, Hash>::find(const K &key) const {
+    const auto index = find_index(key);
+    return index != k_npos ? &entry(index).value : nullptr;
+}
+
+} // namespace v2d
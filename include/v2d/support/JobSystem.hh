@@ -0,0 +1,143 @@
+#pragma once
+
+#include <v2d/support/Array.hh>
+#include <v2d/support/Queue.hh>
+#include <v2d/support/Vector.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace v2d {
+
+class JobSystem;
+
+// Counts the unfinished jobs spawned against it. Waiting on a counter from inside a job, after spawning children
+// against it, is how jobs fork and join.
+class JobCounter {
+    friend JobSystem;
+    std::atomic<std::uint32_t> m_pending{0};
+
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter &) = delete;
+    JobCounter(JobCounter &&) = delete;
+    ~JobCounter() = default;
+
+    JobCounter &operator=(const JobCounter &) = delete;
+    JobCounter &operator=(JobCounter &&) = delete;
+
+    bool done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Work-stealing job system shared by everything that wants to run work in parallel. There is one worker per hardware
+// thread: the thread which creates the system is worker 0 and the rest are background threads. Each worker pushes the
+// jobs it spawns onto its own Chase-Lev deque and pops them in LIFO order, while idle workers steal the oldest jobs
+// from the other end of a random victim's deque. `wait` executes jobs rather than blocking, so waiting from inside a
+// job can't deadlock. Idle background threads sleep until new work is spawned.
+//
+// Jobs may only be spawned and waited on from worker threads. A job is a callable of at most `k_job_storage_size` bytes
+// which is stored inline and never destructed, so it should capture by reference or capture trivial values. A worker
+// with `k_max_jobs` unfinished jobs of its own runs jobs inside `spawn` until one finishes.
+class JobSystem {
+public:
+    static constexpr std::uint32_t k_job_storage_size = 40;
+    static constexpr std::uint32_t k_max_jobs = 4096;
+
+private:
+    struct alignas(k_cache_line_size) Job {
+        void (*invoke)(void *storage);
+        union {
+            JobCounter *counter;
+            // Next job in a free list, once finished.
+            Job *next;
+        };
+        alignas(std::uintptr_t) Array<std::byte, k_job_storage_size> storage;
+        // Index of the worker which allocated the job.
+        std::uint32_t owner;
+    };
+    static_assert(sizeof(Job) == k_cache_line_size);
+    struct Worker;
+
+    Vector<std::unique_ptr<Worker>> m_workers;
+    Vector<std::thread> m_threads;
+    alignas(k_cache_line_size) std::atomic<std::uint32_t> m_wake_epoch{0};
+    std::atomic<std::uint32_t> m_sleeping{0};
+    std::atomic<bool> m_running{true};
+
+    Worker &local_worker();
+    Job &allocate_job();
+    void submit(Job &job, JobCounter &counter);
+    Job *find_job(Worker &worker);
+    void execute(Job &job, Worker &worker);
+    void worker_main(std::uint32_t index);
+
+    template <typename F>
+    void split(JobCounter &counter, std::uint32_t begin, std::uint32_t end, std::uint32_t grain, F &function);
+
+public:
+    // A thread count of zero means one worker per hardware thread.
+    explicit JobSystem(std::uint32_t thread_count = 0);
+    JobSystem(const JobSystem &) = delete;
+    JobSystem(JobSystem &&) = delete;
+    ~JobSystem();
+
+    JobSystem &operator=(const JobSystem &) = delete;
+    JobSystem &operator=(JobSystem &&) = delete;
+
+    template <typename F>
+    void spawn(JobCounter &counter, F &&function);
+    // Executes jobs until `counter` reaches zero.
+    void wait(JobCounter &counter);
+
+    // Calls `function(begin, end)` over [0, count) in ranges of at most `grain` indices, and returns once all have
+    // finished. Ranges are split in halves recursively, so idle workers steal large ranges first.
+    template <typename F>
+    void parallel_for(std::uint32_t count, std::uint32_t grain, F &&function);
+
+    std::uint32_t thread_count() const { return m_workers.size(); }
+};
+
+template <typename F>
+void JobSystem::spawn(JobCounter &counter, F &&function) {
+    using Function = std::decay_t<F>;
+    static_assert(sizeof(Function) <= k_job_storage_size && alignof(Function) <= alignof(std::uintptr_t));
+    static_assert(std::is_trivially_destructible_v<Function>);
+    auto &job = allocate_job();
+    new (job.storage.data()) Function(std::forward<F>(function));
+    job.invoke = [](void *storage) {
+        (*std::launder(static_cast<Function *>(storage)))();
+    };
+    submit(job, counter);
+}
+
+template <typename F>
+void JobSystem::split(JobCounter &counter, std::uint32_t begin, std::uint32_t end, std::uint32_t grain,
+                      F &function) {
+    while (end - begin > grain) {
+        const auto middle = begin + (end - begin) / 2;
+        spawn(counter, [this, &counter, middle, end, grain, &function] {
+            split(counter, middle, end, grain, function);
+        });
+        end = middle;
+    }
+    function(begin, end);
+}
+
+template <typename F>
+void JobSystem::parallel_for(std::uint32_t count, std::uint32_t grain, F &&function) {
+    if (count == 0) {
+        return;
+    }
+    JobCounter counter;
+    split(counter, 0, count, std::max(grain, 1u), function);
+    wait(counter);
+}
+
+} // namespace v2d
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <v2d/support/Array.hh>
+#include <v2d/support/Assert.hh>
+#include <v2d/support/Optional.hh>
+#include <v2d/support/Span.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace v2d {
+
+// Indices written by different threads are kept on separate cache lines so that the writes don't invalidate each
+// other's lines.
+inline constexpr std::size_t k_cache_line_size = 64;
+
+// Bounded lock-free ring buffer with a single producer thread and a single consumer thread. Each side keeps a cached
+// copy of the other side's index and only reloads it when the ring looks full or empty, so in the common case a push
+// or pop touches no cache line written by the other thread except the slot itself.
+template <typename T>
+class SpscRing {
+    struct alignas(T) Slot {
+        Array<std::byte, sizeof(T)> bytes;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::uint32_t m_mask;
+
+    // Consumer side.
+    alignas(k_cache_line_size) std::atomic<std::uint32_t> m_head{0};
+    std::uint32_t m_cached_tail{0};
+
+    // Producer side.
+    alignas(k_cache_line_size) std::atomic<std::uint32_t> m_tail{0};
+    std::uint32_t m_cached_head{0};
+
+    T &slot(std::uint32_t index) { return *std::launder(reinterpret_cast<T *>(&m_slots[index & m_mask])); }
+    std::uint32_t writable(std::uint32_t tail, std::uint32_t wanted);
+    std::uint32_t readable(std::uint32_t head, std::uint32_t wanted);
+
+public:
+    // The capacity must be a power of two.
+    explicit SpscRing(std::uint32_t capacity);
+    SpscRing(const SpscRing &) = delete;
+    SpscRing(SpscRing &&) = delete;
+    ~SpscRing();
+
+    SpscRing &operator=(const SpscRing &) = delete;
+    SpscRing &operator=(SpscRing &&) = delete;
+
+    // Producer only. Returns false if the ring is full.
+    template <typename... Args>
+    bool try_emplace(Args &&...args);
+    bool try_push(const T &elem) { return try_emplace(elem); }
+    bool try_push(T &&elem) { return try_emplace(std::move(elem)); }
+    // Producer only. Pushes as many elements from the front of `elems` as fit, returning how many were pushed.
+    std::uint32_t push_batch(Span<const T> elems);
+
+    // Consumer only.
+    Optional<T> try_pop();
+    // Consumer only. Pops up to `out.size()` elements into `out`, returning how many were popped.
+    std::uint32_t pop_batch(Span<T> out);
+
+    // Approximate when called concurrently with the other side.
+    std::uint32_t size() const {
+        return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_relaxed);
+    }
+    std::uint32_t capacity() const { return m_mask + 1; }
+};
+
+// Bounded lock-free queue with any number of producer threads and a single consumer thread. Producers claim slots by
+// advancing the shared tail with a CAS, which a batch push does once for the whole batch, and then mark each slot as
+// ready with a per-slot sequence number. The consumer never contends with producers on the tail, and publishes its
+// progress once per pop or batch pop.
+template <typename T>
+class MpscQueue {
+    struct Slot {
+        // Position + 1 once the element for the position has been written.
+        std::atomic<std::uint32_t> sequence{0};
+        alignas(T) Array<std::byte, sizeof(T)> bytes;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::uint32_t m_mask;
+
+    // Consumer side.
+    alignas(k_cache_line_size) std::atomic<std::uint32_t> m_head{0};
+
+    // Producer side.
+    alignas(k_cache_line_size) std::atomic<std::uint32_t> m_tail{0};
+
+    Slot &slot(std::uint32_t position) { return m_slots[position & m_mask]; }
+    static T &element(Slot &slot) { return *std::launder(reinterpret_cast<T *>(slot.bytes.data())); }
+    std::uint32_t claim(std::uint32_t count, std::uint32_t &position);
+
+public:
+    // The capacity must be a power of two.
+    explicit MpscQueue(std::uint32_t capacity);
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue(MpscQueue &&) = delete;
+    ~MpscQueue();
+
+    MpscQueue &operator=(const MpscQueue &) = delete;
+    MpscQueue &operator=(MpscQueue &&) = delete;
+
+    // Any thread. Returns false if the queue is full.
+    template <typename... Args>
+    bool try_emplace(Args &&...args);
+    bool try_push(const T &elem) { return try_emplace(elem); }
+    bool try_push(T &&elem) { return try_emplace(std::move(elem)); }
+    // Any thread. Pushes as many elements from the front of `elems` as fit, returning how many were pushed. The pushed
+    // elements are contiguous in the queue.
+    std::uint32_t push_batch(Span<const T> elems);
+
+    // Consumer only. An element whose producer has claimed its slot but not yet finished writing it blocks the
+    // elements behind it, so these can return less than is claimed.
+    Optional<T> try_pop();
+    std::uint32_t pop_batch(Span<T> out);
+
+    // Approximate when called concurrently with producers.
+    std::uint32_t size() const {
+        return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_relaxed);
+    }
+    std::uint32_t capacity() const { return m_mask + 1; }
+};
+
+template <typename T>
+SpscRing<T>::SpscRing(std::uint32_t capacity) : m_slots(new Slot[capacity]), m_mask(capacity - 1) {
+    V2D_ASSERT(std::has_single_bit(capacity));
+}
+
+template <typename T>
+SpscRing<T>::~SpscRing() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        for (auto head = m_head.load(std::memory_order_relaxed); head != tail; head++) {
+            slot(head).~T();
+        }
+    }
+}
+
+template <typename T>
+std::uint32_t SpscRing<T>::writable(std::uint32_t tail, std::uint32_t wanted) {
+    if (capacity() - (tail - m_cached_head) < wanted) {
+        m_cached_head = m_head.load(std::memory_order_acquire);
+    }
+    return capacity() - (tail - m_cached_head);
+}
+
+template <typename T>
+std::uint32_t SpscRing<T>::readable(std::uint32_t head, std::uint32_t wanted) {
+    if (m_cached_tail - head < wanted) {
+        m_cached_tail = m_tail.load(std::memory_order_acquire);
+    }
+    return m_cached_tail - head;
+}
+
+template <typename T>
+template <typename... Args>
+bool SpscRing<T>::try_emplace(Args &&...args) {
+    const auto tail = m_tail.load(std::memory_order_relaxed);
+    if (writable(tail, 1) == 0) {
+        return false;
+    }
+    new (&m_slots[tail & m_mask]) T(std::forward<Args>(args)...);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+std::uint32_t SpscRing<T>::push_batch(Span<const T> elems) {
+    const auto tail = m_tail.load(std::memory_order_relaxed);
+    const auto count = std::min(elems.size(), writable(tail, elems.size()));
+    for (std::uint32_t i = 0; i < count; i++) {
+        new (&m_slots[(tail + i) & m_mask]) T(elems[i]);
+    }
+    m_tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+template <typename T>
+Optional<T> SpscRing<T>::try_pop() {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    if (readable(head, 1) == 0) {
+        return {};
+    }
+    auto &elem = slot(head);
+    Optional<T> result(std::move(elem));
+    elem.~T();
+    m_head.store(head + 1, std::memory_order_release);
+    return result;
+}
+
+template <typename T>
+std::uint32_t SpscRing<T>::pop_batch(Span<T> out) {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    const auto count = std::min(out.size(), readable(head, out.size()));
+    for (std::uint32_t i = 0; i < count; i++) {
+        auto &elem = slot(head + i);
+        out[i] = std::move(elem);
+        elem.~T();
+    }
+    m_head.store(head + count, std::memory_order_release);
+    return count;
+}
+
+template <typename T>
+MpscQueue<T>::MpscQueue(std::uint32_t capacity) : m_slots(new Slot[capacity]), m_mask(capacity - 1) {
+    V2D_ASSERT(std::has_single_bit(capacity));
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        for (auto head = m_head.load(std::memory_order_relaxed); head != tail; head++) {
+            element(slot(head)).~T();
+        }
+    }
+}
+
+template <typename T>
+std::uint32_t MpscQueue<T>::claim(std::uint32_t count, std::uint32_t &position) {
+    position = m_tail.load(std::memory_order_relaxed);
+    while (true) {
+        // Acquire pairs with the consumer's release of the head, so that it has finished reading any slot we reuse.
+        const auto head = m_head.load(std::memory_order_acquire);
+        const auto claimed = std::min(count, capacity() - (position - head));
+        if (claimed == 0) {
+            return 0;
+        }
+        if (m_tail.compare_exchange_weak(position, position + claimed, std::memory_order_relaxed)) {
+            return claimed;
+        }
+    }
+}
+
+template <typename T>
+template <typename... Args>
+bool MpscQueue<T>::try_emplace(Args &&...args) {
+    std::uint32_t position;
+    if (claim(1, position) == 0) {
+        return false;
+    }
+    auto &target = slot(position);
+    new (target.bytes.data()) T(std::forward<Args>(args)...);
+    target.sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+std::uint32_t MpscQueue<T>::push_batch(Span<const T> elems) {
+    std::uint32_t position;
+    const auto count = claim(std::min(elems.size(), capacity()), position);
+    for (std::uint32_t i = 0; i < count; i++) {
+        auto &target = slot(position + i);
+        new (target.bytes.data()) T(elems[i]);
+        target.sequence.store(position + i + 1, std::memory_order_release);
+    }
+    return count;
+}
+
+template <typename T>
+Optional<T> MpscQueue<T>::try_pop() {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    auto &source = slot(head);
+    if (source.sequence.load(std::memory_order_acquire) != head + 1) {
+        return {};
+    }
+    auto &elem = element(source);
+    Optional<T> result(std::move(elem));
+    elem.~T();
+    m_head.store(head + 1, std::memory_order_release);
+    return result;
+}
+
+template <typename T>
+std::uint32_t MpscQueue<T>::pop_batch(Span<T> out) {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    std::uint32_t count = 0;
+    for (; count < out.size(); count++) {
+        auto &source = slot(head + count);
+        if (source.sequence.load(std::memory_order_acquire) != head + count + 1) {
+            break;
+        }
+        auto &elem = element(source);
+        out[count] = std::move(elem);
+        elem.~T();
+    }
+    m_head.store(head + count, std::memory_order_release);
+    return count;
+}
+
+} // namespace v2d
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+namespace v2d {
+
+// Whether moving an object to a new address and destroying the old one is equivalent to copying its bytes, which is
+// true for most types that don't hold pointers into themselves. Containers use it to relocate elements with memcpy.
+// Specialise it for such types that aren't trivially copyable.
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_trivially_relocatable_v = IsTriviallyRelocatable<T>::value;
+
+} // namespace v2d
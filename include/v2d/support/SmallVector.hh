@@ -0,0 +1,179 @@
+#pragma once
+
+#include <v2d/support/Allocator.hh>
+#include <v2d/support/Array.hh>
+#include <v2d/support/Assert.hh>
+#include <v2d/support/Relocatable.hh>
+#include <v2d/support/Span.hh>
+#include <v2d/support/Vector.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace v2d {
+
+// Vector with inline storage for the first `N` elements, only spilling to the heap beyond that. Intended for short
+// lists which are usually small, where a heap allocation would cost more than the work done with the list.
+template <typename T, std::uint32_t N, typename SizeType = std::uint32_t>
+class SmallVector {
+    static_assert(N != 0);
+
+    alignas(T) Array<std::byte, N * sizeof(T)> m_inline;
+    T *m_data{reinterpret_cast<T *>(m_inline.data())};
+    SizeType m_capacity{N};
+    SizeType m_size{0};
+
+    bool is_inline() const { return m_data == reinterpret_cast<const T *>(m_inline.data()); }
+    void relocate(T *dst);
+
+public:
+    SmallVector() = default;
+    SmallVector(const SmallVector &) = delete;
+    SmallVector(SmallVector &&other) noexcept;
+    ~SmallVector();
+
+    SmallVector &operator=(const SmallVector &) = delete;
+    SmallVector &operator=(SmallVector &&) = delete;
+
+    void clear();
+    void ensure_capacity(SizeType capacity);
+    template <typename... Args>
+    void ensure_size(SizeType size, Args &&...args);
+
+    template <typename... Args>
+    T &emplace(Args &&...args);
+    void push(const T &elem) { emplace(elem); }
+    void push(T &&elem) { emplace(std::move(elem)); }
+    void pop();
+
+    Span<T, SizeType> span() { return {m_data, m_size}; }
+    Span<const T, SizeType> span() const { return {m_data, m_size}; }
+
+    T *begin() { return m_data; }
+    T *end() { return m_data + m_size; }
+    const T *begin() const { return m_data; }
+    const T *end() const { return m_data + m_size; }
+
+    T &operator[](SizeType index);
+    const T &operator[](SizeType index) const;
+
+    T &first() { return begin()[0]; }
+    const T &first() const { return begin()[0]; }
+    T &last() { return end()[-1]; }
+    const T &last() const { return end()[-1]; }
+
+    bool empty() const { return m_size == 0; }
+    T *data() { return m_data; }
+    const T *data() const { return m_data; }
+    SizeType capacity() const { return m_capacity; }
+    SizeType size() const { return m_size; }
+    SizeType size_bytes() const { return m_size * sizeof(T); }
+};
+
+template <typename T, std::uint32_t N, typename SizeType>
+SmallVector<T, N, SizeType>::SmallVector(SmallVector &&other) noexcept {
+    if (!other.is_inline()) {
+        m_data = std::exchange(other.m_data, reinterpret_cast<T *>(other.m_inline.data()));
+        m_capacity = std::exchange(other.m_capacity, N);
+        m_size = std::exchange(other.m_size, 0u);
+        return;
+    }
+    other.relocate(m_data);
+    m_size = std::exchange(other.m_size, 0u);
+}
+
+template <typename T, std::uint32_t N, typename SizeType>
+SmallVector<T, N, SizeType>::~SmallVector() {
+    clear();
+    if (!is_inline()) {
+        heap_allocator().deallocate(m_data);
+    }
+}
+
+// Moves the elements to `dst` and destroys the originals, leaving the size unchanged.
+template <typename T, std::uint32_t N, typename SizeType>
+void SmallVector<T, N, SizeType>::relocate(T *dst) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (m_size != 0) {
+            std::memcpy(static_cast<void *>(dst), m_data, size_bytes());
+        }
+    } else {
+        for (auto &elem : *this) {
+            new (dst++) T(std::move(elem));
+            elem.~T();
+        }
+    }
+}
+
+template <typename T, std::uint32_t N, typename SizeType>
+void SmallVector<T, N, SizeType>::clear() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        for (auto *elem = end(); elem != begin();) {
+            (--elem)->~T();
+        }
+    }
+    m_size = 0;
+}
+
+template <typename T, std::uint32_t N, typename SizeType>
+void SmallVector<T, N, SizeType>::ensure_capacity(SizeType capacity) {
+    if (capacity <= m_capacity) {
+        return;
+    }
+    capacity = std::max(m_capacity * 2 + 1, capacity);
+    auto *new_data = static_cast<T *>(heap_allocator().allocate(capacity * sizeof(T), alignof(T)));
+    allocation_counter()++;
+    relocate(new_data);
+    if (!is_inline()) {
+        heap_allocator().deallocate(m_data);
+    }
+    m_data = new_data;
+    m_capacity = capacity;
+}
+
+template <typename T, std::uint32_t N, typename SizeType>
+template <typename... Args>
+void SmallVector<T, N, SizeType>::ensure_size(SizeType size, Args &&...args) {
+    if (size <= m_size) {
+        return;
+    }
+    ensure_capacity(size);
+    for (SizeType i = m_size; i < size; i++) {
+        new (begin() + i) T(std::forward<Args>(args)...);
+    }
+    m_size = size;
+}
+
+template <typename T, std::uint32_t N, typename SizeType>
+template <typename... Args>
+T &SmallVector<T, N, SizeType>::emplace(Args &&...args) {
+    ensure_capacity(m_size + 1);
+    new (end()) T(std::forward<Args>(args)...);
+    return (*this)[m_size++];
+}
+
+template <typename T, std::uint32_t N, typename SizeType>
+void SmallVector<T, N, SizeType>::pop() {
+    V2D_ASSERT(!empty());
+    m_size--;
+    end()->~T();
+}
+
+template <typename T, std::uint32_t N, typename SizeType>
+T &SmallVector<T, N, SizeType>::operator[](SizeType index) {
+    V2D_ASSERT(index < m_size);
+    return begin()[index];
+}
+
+template <typename T, std::uint32_t N, typename SizeType>
+const T &SmallVector<T, N, SizeType>::operator[](SizeType index) const {
+    V2D_ASSERT(index < m_size);
+    return begin()[index];
+}
+
+} // namespace v2d
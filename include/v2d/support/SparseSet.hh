@@ -1,36 +1,81 @@
 #pragma once
 
 #include <v2d/support/Assert.hh>
+#include <v2d/support/Span.hh>
 #include <v2d/support/Vector.hh>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 
 namespace v2d {
 
 template <typename E, typename I>
 class SparseSet {
+public:
+    // Component storage starts on a cache line, so that kernels over it can use aligned vector loads.
+    static constexpr std::size_t k_storage_alignment = 64;
+    using Storage = Vector<E, std::uint32_t, k_storage_alignment>;
+    // Granularity of write tracking. Each page of storage records the write epoch in which an element on it was last
+    // handed out for writing, through `get_mut` or `mark_dirty`. Const access doesn't mark anything. Something which
+    // copies storage, such as a snapshot, calls `advance_epoch` whenever it is in sync and keeps the returned epoch,
+    // and next time only copies the pages with a later one. Any number of copies can track the same set.
+    static constexpr std::size_t k_page_size = 4096;
+
+private:
     Vector<I, I> m_dense;
     Vector<I, I> m_sparse;
-    Vector<E> m_storage;
+    Storage m_storage;
+    std::size_t m_version{0};
+    Vector<std::size_t> m_page_epochs;
+    std::size_t m_epoch{1};
+
+    void track_storage_size();
 
 public:
     bool contains(I index) const;
     template <typename... Args>
     void insert(I index, Args &&...args);
     void remove(I index);
+    void arrange(const Vector<I, I> &order);
+    void assign(const I *dense, const E *storage, I size, const I *sparse, I sparse_size);
+    void set_allocator(Allocator *allocator);
 
     auto dense_begin() { return m_dense.begin(); }
     auto dense_end() { return m_dense.end(); };
-    auto storage_begin() { return m_storage.begin(); }
+    // Marks all of storage dirty, since the caller may write anywhere in it.
+    auto storage_begin() {
+        std::fill(m_page_epochs.begin(), m_page_epochs.end(), m_epoch);
+        return m_storage.begin();
+    }
     auto storage_end() { return m_storage.end(); };
+    // Mutable storage without marking anything dirty, for callers which mark what they write with `mark_dirty`.
+    E *untracked_storage() { return m_storage.data(); }
+    const Vector<I, I> &dense() const { return m_dense; }
+    const Vector<I, I> &sparse() const { return m_sparse; }
+    const Storage &storage() const { return m_storage; }
 
-    E &operator[](I index);
     const E &operator[](I index) const;
+    E &get_mut(I index);
 
     bool empty() const { return m_dense.empty(); }
     I size() const { return m_dense.size(); }
+
+    // Incremented whenever the dense or sparse arrays change.
+    std::size_t version() const { return m_version; }
+
+    void mark_dirty(const E *elem);
+    void mark_page_dirty(std::uint32_t page) { m_page_epochs[page] = m_epoch; }
+    Span<const std::size_t> page_epochs() const { return {m_page_epochs.data(), m_page_epochs.size()}; }
+    // Returns the current epoch and starts a new one, so that every write so far is stamped with at most the returned
+    // epoch and every later one with a greater epoch.
+    std::size_t advance_epoch() { return m_epoch++; }
 };
 
+template <typename E, typename I>
+struct IsTriviallyRelocatable<SparseSet<E, I>> : std::true_type {};
+
 template <typename E, typename I>
 bool SparseSet<E, I>::contains(I index) const {
     return index < m_sparse.size() && m_sparse[index] < m_dense.size() && m_dense[m_sparse[index]] == index;
@@ -44,6 +89,8 @@ void SparseSet<E, I>::insert(I index, Args &&...args) {
     m_sparse[index] = m_dense.size();
     m_dense.push(index);
     m_storage.emplace(std::forward<Args>(args)...);
+    m_version++;
+    track_storage_size();
 }
 
 template <typename E, typename I>
@@ -57,12 +104,58 @@ void SparseSet<E, I>::remove(I index) {
     }
     m_dense.pop();
     m_storage.pop();
+    m_version++;
 }
 
+// Reorders the set so that the dense array matches `order`, which must be a permutation of the current dense array.
 template <typename E, typename I>
-E &SparseSet<E, I>::operator[](I index) {
-    V2D_ASSERT(contains(index));
-    return m_storage[m_sparse[index]];
+void SparseSet<E, I>::arrange(const Vector<I, I> &order) {
+    V2D_ASSERT(order.size() == m_dense.size());
+    Storage storage(m_storage.allocator());
+    storage.ensure_capacity(m_storage.size());
+    for (I i = 0; i < order.size(); i++) {
+        V2D_ASSERT_PEDANTIC(contains(order[i]));
+        storage.push(std::move(m_storage[m_sparse[order[i]]]));
+    }
+    for (I i = 0; i < order.size(); i++) {
+        m_dense[i] = order[i];
+        m_sparse[order[i]] = i;
+    }
+    m_storage = std::move(storage);
+    m_version++;
+}
+
+// Replaces the contents of the set with copies of the given raw arrays.
+template <typename E, typename I>
+void SparseSet<E, I>::assign(const I *dense, const E *storage, I size, const I *sparse, I sparse_size) {
+    m_dense.assign(dense, size);
+    m_sparse.assign(sparse, sparse_size);
+    m_storage.assign(storage, size);
+    m_version++;
+    track_storage_size();
+}
+
+template <typename E, typename I>
+void SparseSet<E, I>::set_allocator(Allocator *allocator) {
+    m_dense.set_allocator(allocator);
+    m_sparse.set_allocator(allocator);
+    m_storage.set_allocator(allocator);
+}
+
+template <typename E, typename I>
+void SparseSet<E, I>::track_storage_size() {
+    const auto bytes = m_storage.size() * sizeof(E);
+    m_page_epochs.ensure_size(static_cast<std::uint32_t>((bytes + k_page_size - 1) / k_page_size), m_epoch);
+}
+
+template <typename E, typename I>
+void SparseSet<E, I>::mark_dirty(const E *elem) {
+    const auto offset = static_cast<std::size_t>(elem - m_storage.data()) * sizeof(E);
+    const auto first = static_cast<std::uint32_t>(offset / k_page_size);
+    const auto last = static_cast<std::uint32_t>((offset + sizeof(E) - 1) / k_page_size);
+    for (auto page = first; page <= last; page++) {
+        m_page_epochs[page] = m_epoch;
+    }
 }
 
 template <typename E, typename I>
@@ -71,4 +164,12 @@ const E &SparseSet<E, I>::operator[](I index) const {
     return m_storage[m_sparse[index]];
 }
 
+template <typename E, typename I>
+E &SparseSet<E, I>::get_mut(I index) {
+    V2D_ASSERT(contains(index));
+    auto &elem = m_storage[m_sparse[index]];
+    mark_dirty(&elem);
+    return elem;
+}
+
 } // namespace v2d
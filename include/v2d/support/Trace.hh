@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+// Scoped trace zones, recorded into per-thread ring buffers and exportable as Chrome trace event JSON (viewable in
+// chrome://tracing or Perfetto). Compiled out unless V2D_TRACING is defined.
+#define V2D_TRACE_CONCAT_A(a, b) a##b
+#define V2D_TRACE_CONCAT(a, b) V2D_TRACE_CONCAT_A(a, b)
+#ifdef V2D_TRACING
+#define V2D_TRACE_SCOPE(name) const v2d::TraceZone V2D_TRACE_CONCAT(trace_zone_, __LINE__)(name)
+#else
+#define V2D_TRACE_SCOPE(name)
+#endif
+
+namespace v2d {
+
+// Records a complete event spanning its lifetime. `name` must outlive the trace, e.g. a string literal.
+class TraceZone {
+    const char *m_name;
+    std::uint64_t m_start;
+
+public:
+    explicit TraceZone(const char *name);
+    TraceZone(const TraceZone &) = delete;
+    TraceZone(TraceZone &&) = delete;
+    ~TraceZone();
+
+    TraceZone &operator=(const TraceZone &) = delete;
+    TraceZone &operator=(TraceZone &&) = delete;
+};
+
+// Writes the events currently held in every thread's ring buffer. Returns false if the file couldn't be written.
+bool export_chrome_trace(const char *path);
+
+} // namespace v2d
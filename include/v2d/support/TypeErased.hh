@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <new>
 
 namespace v2d {
 
@@ -11,7 +12,11 @@ class TypeErased {
 public:
     template <typename U>
     Container<U, Extra...> &as() {
-        return *reinterpret_cast<Container<U, Extra...> *>(&m_container);
+        return *std::launder(reinterpret_cast<Container<U, Extra...> *>(&m_container));
+    }
+    template <typename U>
+    const Container<U, Extra...> &as() const {
+        return *std::launder(reinterpret_cast<const Container<U, Extra...> *>(&m_container));
     }
 };
 
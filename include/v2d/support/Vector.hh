@@ -1,6 +1,8 @@
 #pragma once
 
+#include <v2d/support/Allocator.hh>
 #include <v2d/support/Assert.hh>
+#include <v2d/support/Relocatable.hh>
 #include <v2d/support/Span.hh>
 
 #include <algorithm>
@@ -11,30 +13,40 @@
 
 namespace v2d {
 
-template <typename T, typename SizeType = std::uint32_t>
+// Buffers are aligned to at least `Alignment` bytes, e.g. 64 to start on a cache line for aligned vector loads.
+template <typename T, typename SizeType = std::uint32_t, std::size_t Alignment = alignof(T)>
 class Vector {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static constexpr std::size_t k_alignment = std::max(Alignment, alignof(T));
+
     T *m_data{nullptr};
     SizeType m_capacity{0};
     SizeType m_size{0};
+    // Null means the heap, which keeps default construction constexpr.
+    Allocator *m_allocator{nullptr};
 
 public:
     constexpr Vector() = default;
+    constexpr explicit Vector(Allocator &allocator) : m_allocator(&allocator) {}
     template <typename... Args>
     explicit Vector(SizeType size, Args &&...args);
     Vector(const Vector &);
     Vector(Vector &&other) noexcept
         : m_data(std::exchange(other.m_data, nullptr)), m_capacity(std::exchange(other.m_capacity, 0u)),
-          m_size(std::exchange(other.m_size, 0u)) {}
+          m_size(std::exchange(other.m_size, 0u)), m_allocator(other.m_allocator) {}
     ~Vector();
 
     Vector &operator=(const Vector &) = delete;
     Vector &operator=(Vector &&) noexcept;
 
+    void assign(const T *data, SizeType count);
     void clear();
     void ensure_capacity(SizeType capacity);
     template <typename... Args>
     void ensure_size(SizeType size, Args &&...args);
     void reallocate(SizeType capacity);
+    // Changes where future buffers come from. Must be called before the vector first allocates.
+    void set_allocator(Allocator *allocator);
 
     template <typename... Args>
     T &emplace(Args &&...args);
@@ -58,6 +70,7 @@ public:
     T &last() { return end()[-1]; }
     const T &last() const { return end()[-1]; }
 
+    Allocator &allocator() const { return m_allocator != nullptr ? *m_allocator : heap_allocator(); }
     bool empty() const { return m_size == 0; }
     T *data() const { return m_data; }
     SizeType capacity() const { return m_capacity; }
@@ -68,14 +81,23 @@ public:
 template <typename T>
 using LargeVector = Vector<T, std::size_t>;
 
-template <typename T, typename SizeType>
+template <typename T, typename SizeType, std::size_t Alignment>
+struct IsTriviallyRelocatable<Vector<T, SizeType, Alignment>> : std::true_type {};
+
+// The number of buffers allocated by vectors on the calling thread, used by the system profiler.
+inline std::size_t &allocation_counter() {
+    thread_local std::size_t count = 0;
+    return count;
+}
+
+template <typename T, typename SizeType, std::size_t Alignment>
 template <typename... Args>
-Vector<T, SizeType>::Vector(SizeType size, Args &&...args) {
+Vector<T, SizeType, Alignment>::Vector(SizeType size, Args &&...args) {
     ensure_size(size, std::forward<Args>(args)...);
 }
 
-template <typename T, typename SizeType>
-Vector<T, SizeType>::Vector(const Vector &other) {
+template <typename T, typename SizeType, std::size_t Alignment>
+Vector<T, SizeType, Alignment>::Vector(const Vector &other) {
     ensure_capacity(other.size());
     m_size = other.size();
     if constexpr (!std::is_trivially_copyable_v<T>) {
@@ -87,25 +109,45 @@ Vector<T, SizeType>::Vector(const Vector &other) {
     }
 }
 
-template <typename T, typename SizeType>
-Vector<T, SizeType>::~Vector() {
+template <typename T, typename SizeType, std::size_t Alignment>
+Vector<T, SizeType, Alignment>::~Vector() {
     clear();
-    delete[] reinterpret_cast<std::uint8_t *>(m_data);
+    if (m_data != nullptr) {
+        allocator().deallocate(m_data);
+    }
 }
 
-template <typename T, typename SizeType>
-Vector<T, SizeType> &Vector<T, SizeType>::operator=(Vector &&other) noexcept {
+template <typename T, typename SizeType, std::size_t Alignment>
+Vector<T, SizeType, Alignment> &Vector<T, SizeType, Alignment>::operator=(Vector &&other) noexcept {
     if (this != &other) {
         clear();
+        if (m_data != nullptr) {
+            allocator().deallocate(m_data);
+        }
         m_data = std::exchange(other.m_data, nullptr);
         m_capacity = std::exchange(other.m_capacity, 0u);
         m_size = std::exchange(other.m_size, 0u);
+        m_allocator = other.m_allocator;
     }
     return *this;
 }
 
-template <typename T, typename SizeType>
-void Vector<T, SizeType>::clear() {
+template <typename T, typename SizeType, std::size_t Alignment>
+void Vector<T, SizeType, Alignment>::assign(const T *data, SizeType count) {
+    clear();
+    ensure_capacity(count);
+    if constexpr (!std::is_trivially_copyable_v<T>) {
+        for (SizeType i = 0; i < count; i++) {
+            new (begin() + i) T(data[i]);
+        }
+    } else if (count != 0) {
+        std::memcpy(m_data, data, count * sizeof(T));
+    }
+    m_size = count;
+}
+
+template <typename T, typename SizeType, std::size_t Alignment>
+void Vector<T, SizeType, Alignment>::clear() {
     if constexpr (!std::is_trivially_destructible_v<T>) {
         for (auto *elem = end(); elem != begin();) {
             (--elem)->~T();
@@ -114,16 +156,16 @@ void Vector<T, SizeType>::clear() {
     m_size = 0;
 }
 
-template <typename T, typename SizeType>
-void Vector<T, SizeType>::ensure_capacity(SizeType capacity) {
+template <typename T, typename SizeType, std::size_t Alignment>
+void Vector<T, SizeType, Alignment>::ensure_capacity(SizeType capacity) {
     if (capacity > m_capacity) {
         reallocate(std::max(m_capacity * 2 + 1, capacity));
     }
 }
 
-template <typename T, typename SizeType>
+template <typename T, typename SizeType, std::size_t Alignment>
 template <typename... Args>
-void Vector<T, SizeType>::ensure_size(SizeType size, Args &&...args) {
+void Vector<T, SizeType, Alignment>::ensure_size(SizeType size, Args &&...args) {
     if (size <= m_size) {
         return;
     }
@@ -138,37 +180,50 @@ void Vector<T, SizeType>::ensure_size(SizeType size, Args &&...args) {
     m_size = size;
 }
 
-template <typename T, typename SizeType>
-void Vector<T, SizeType>::reallocate(SizeType capacity) {
+template <typename T, typename SizeType, std::size_t Alignment>
+void Vector<T, SizeType, Alignment>::reallocate(SizeType capacity) {
     V2D_ASSERT(capacity >= m_size);
-    T *new_data = reinterpret_cast<T *>(new std::uint8_t[capacity * sizeof(T)]);
-    if constexpr (!std::is_trivially_copyable_v<T>) {
+    allocation_counter()++;
+    if constexpr (is_trivially_relocatable_v<T>) {
+        // Let the allocator move the bytes, which for large heap buffers means remapping rather than copying.
+        if (m_data != nullptr) {
+            m_data = static_cast<T *>(allocator().reallocate(m_data, size_bytes(), capacity * sizeof(T), k_alignment));
+            m_capacity = capacity;
+            return;
+        }
+    }
+    T *new_data = static_cast<T *>(allocator().allocate(capacity * sizeof(T), k_alignment));
+    if constexpr (!is_trivially_relocatable_v<T>) {
         for (auto *data = new_data; auto &elem : *this) {
             new (data++) T(std::move(elem));
         }
         for (auto *elem = end(); elem != begin();) {
             (--elem)->~T();
         }
-    } else {
-        if (m_size != 0) {
-            std::memcpy(new_data, m_data, size_bytes());
-        }
     }
-    delete[] reinterpret_cast<std::uint8_t *>(m_data);
+    if (m_data != nullptr) {
+        allocator().deallocate(m_data);
+    }
     m_data = new_data;
     m_capacity = capacity;
 }
 
-template <typename T, typename SizeType>
+template <typename T, typename SizeType, std::size_t Alignment>
+void Vector<T, SizeType, Alignment>::set_allocator(Allocator *allocator) {
+    V2D_ASSERT(m_data == nullptr, "Vector already allocated");
+    m_allocator = allocator;
+}
+
+template <typename T, typename SizeType, std::size_t Alignment>
 template <typename... Args>
-T &Vector<T, SizeType>::emplace(Args &&...args) {
+T &Vector<T, SizeType, Alignment>::emplace(Args &&...args) {
     ensure_capacity(m_size + 1);
     new (end()) T(std::forward<Args>(args)...);
     return (*this)[m_size++];
 }
 
-template <typename T, typename SizeType>
-void Vector<T, SizeType>::push(const T &elem) {
+template <typename T, typename SizeType, std::size_t Alignment>
+void Vector<T, SizeType, Alignment>::push(const T &elem) {
     ensure_capacity(m_size + 1);
     if constexpr (std::is_trivially_copyable_v<T>) {
         std::memcpy(end(), &elem, sizeof(T));
@@ -178,28 +233,28 @@ void Vector<T, SizeType>::push(const T &elem) {
     m_size++;
 }
 
-template <typename T, typename SizeType>
-void Vector<T, SizeType>::push(T &&elem) {
+template <typename T, typename SizeType, std::size_t Alignment>
+void Vector<T, SizeType, Alignment>::push(T &&elem) {
     ensure_capacity(m_size + 1);
     new (end()) T(std::move(elem));
     m_size++;
 }
 
-template <typename T, typename SizeType>
-void Vector<T, SizeType>::pop() {
+template <typename T, typename SizeType, std::size_t Alignment>
+void Vector<T, SizeType, Alignment>::pop() {
     V2D_ASSERT(!empty());
     m_size--;
     end()->~T();
 }
 
-template <typename T, typename SizeType>
-T &Vector<T, SizeType>::operator[](SizeType index) {
+template <typename T, typename SizeType, std::size_t Alignment>
+T &Vector<T, SizeType, Alignment>::operator[](SizeType index) {
     V2D_ASSERT(index < m_size);
     return begin()[index];
 }
 
-template <typename T, typename SizeType>
-const T &Vector<T, SizeType>::operator[](SizeType index) const {
+template <typename T, typename SizeType, std::size_t Alignment>
+const T &Vector<T, SizeType, Alignment>::operator[](SizeType index) const {
     V2D_ASSERT(index < m_size);
     return begin()[index];
 }
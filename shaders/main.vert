@@ -1,8 +1,9 @@
 #version 450
 
 struct ObjectData {
-    vec2 position;
-    vec2 scale;
+    vec2 basis_x;
+    vec2 basis_y;
+    vec2 translation;
     vec2 sprite_cell;
 };
 
@@ -23,8 +24,9 @@ const vec2 k_vertices[6] = vec2[6](
 
 void main() {
     ObjectData object = g_objects[gl_InstanceIndex];
-    vec2 position = k_vertices[gl_VertexIndex] * object.scale + (object.position * 2.0f - 1.0f);
-    vec2 uv = (k_vertices[gl_VertexIndex] + 1.0f) * 0.5f;
+    vec2 vertex = k_vertices[gl_VertexIndex];
+    vec2 position = object.basis_x * vertex.x + object.basis_y * vertex.y + (object.translation * 2.0f - 1.0f);
+    vec2 uv = (vertex + 1.0f) * 0.5f;
     gl_Position = vec4(position, 0.0f, 1.0f);
     g_uv = (uv + object.sprite_cell) / 6.0f;
 }
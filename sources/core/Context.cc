@@ -1,6 +1,7 @@
 #include <v2d/core/Context.hh>
 
 #include <v2d/support/Assert.hh>
+#include <v2d/support/SmallVector.hh>
 #include <v2d/support/Vector.hh>
 
 #include <algorithm>
@@ -84,7 +85,7 @@ Context::Context(Span<const char *const> extensions) {
     m_queue_families.ensure_size(queue_family_count);
     vkGetPhysicalDeviceQueueFamilyProperties(m_physical_device, &queue_family_count, m_queue_families.data());
 
-    Vector<VkDeviceQueueCreateInfo> queue_cis;
+    SmallVector<VkDeviceQueueCreateInfo, 4> queue_cis;
     const float queue_priority = 1.0f;
     for (std::uint32_t i = 0; i < m_queue_families.size(); i++) {
         queue_cis.push({
@@ -0,0 +1,106 @@
+#include <v2d/core/TransformSystem.hh>
+
+#include <v2d/core/Transform.hh>
+#include <v2d/ecs/Hierarchy.hh>
+#include <v2d/ecs/World.hh>
+#include <v2d/support/Trace.hh>
+
+namespace v2d {
+namespace {
+
+// Returns true if the entity didn't have a world transform yet.
+bool set_world_transform(Entity entity, const WorldTransform &world_transform) {
+    if (entity.has<WorldTransform>()) {
+        entity.get_mut<WorldTransform>() = world_transform;
+        return false;
+    }
+    entity.add<WorldTransform>(world_transform);
+    return true;
+}
+
+} // namespace
+
+void TransformSystem::update(World *world, float) {
+    V2D_TRACE_SCOPE("TransformSystem::update");
+    world->sort_hierarchy();
+    const bool hierarchy_changed = world->hierarchy_version() != m_hierarchy_version;
+    if (hierarchy_changed) {
+        // Keep the transform sets in the same order as the hierarchy so that the sweep below is linear in all three.
+        m_hierarchy_version = world->hierarchy_version();
+        world->sort_as<Transform, Hierarchy>();
+    }
+
+    // Since the hierarchy is stored in depth-first pre-order, the parent of a node at depth d is always the last node
+    // visited at depth d - 1. A node is recomputed if its own transform is dirty or if its parent was recomputed. Only
+    // components which are written are accessed mutably, so a static scene leaves its storage pages clean for snapshots
+    // and publishing.
+    std::size_t recomputed_count = 0;
+    bool world_transforms_changed = hierarchy_changed;
+    for (auto [entity, node] : world->view<Hierarchy>()) {
+        const auto depth = node->depth();
+        // Copy construct rather than zero the new elements, since a zero matrix isn't the identity.
+        m_parent_stack.ensure_size(depth + 1, WorldTransform());
+        m_recomputed_stack.ensure_size(depth + 1);
+
+        const bool parent_recomputed = depth != 0 && m_recomputed_stack[depth - 1];
+        if (!entity.has<Transform>()) {
+            // Nodes without a transform pass their parent's world transform through to their children. One which
+            // still has a world transform lost its transform since the last update, so its subtree has moved.
+            const bool stale = entity.has<WorldTransform>();
+            if (stale) {
+                entity.remove<WorldTransform>();
+                world_transforms_changed = true;
+            }
+            m_parent_stack[depth] = depth != 0 ? m_parent_stack[depth - 1] : WorldTransform();
+            m_recomputed_stack[depth] = hierarchy_changed || parent_recomputed || stale;
+            continue;
+        }
+
+        const auto &transform = entity.get<Transform>();
+        const bool recompute =
+            hierarchy_changed || parent_recomputed || transform.m_dirty || !entity.has<WorldTransform>();
+        m_recomputed_stack[depth] = recompute;
+        if (!recompute) {
+            m_parent_stack[depth] = entity.get<WorldTransform>();
+            continue;
+        }
+
+        const WorldTransform local(transform);
+        if (transform.m_dirty) {
+            entity.get_mut<Transform>().m_dirty = false;
+        }
+        m_parent_stack[depth] = depth != 0 ? m_parent_stack[depth - 1] * local : local;
+        world_transforms_changed |= set_world_transform(entity, m_parent_stack[depth]);
+        recomputed_count++;
+    }
+
+    // Any transforms still dirty belong to entities outside of a hierarchy.
+    for (auto [entity, transform] : world->view<Transform>()) {
+        if (transform->m_dirty) {
+            entity.get_mut<Transform>().m_dirty = false;
+            world_transforms_changed |= set_world_transform(entity, WorldTransform(*transform));
+            recomputed_count++;
+        }
+    }
+
+    // Every entity with a transform now has a world transform, so any extra world transforms are left over from
+    // removed transforms.
+    if (world->view<WorldTransform>().size() != world->view<Transform>().size()) {
+        m_stale_entities.clear();
+        for (auto [entity, world_transform] : world->view<WorldTransform>()) {
+            if (!entity.has<Transform>()) {
+                m_stale_entities.push(entity.id());
+            }
+        }
+        for (const auto id : m_stale_entities) {
+            world->remove_component<WorldTransform>(id);
+        }
+        world_transforms_changed = true;
+    }
+    if (world_transforms_changed) {
+        world->sort_as<WorldTransform, Hierarchy>();
+    }
+    count_entities(recomputed_count);
+}
+
+} // namespace v2d
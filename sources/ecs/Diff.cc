@@ -0,0 +1,282 @@
+#include <v2d/ecs/Snapshot.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace v2d {
+namespace {
+
+// Diff layout, with all integers LEB128 varints:
+//   entity_count next_id set_count
+//   per set: component_id element_size
+//            removed_count (zigzag id delta)*
+//            upserted_count ((zigzag id delta) xor_runs)*
+// where xor_runs is a sequence of (zero_run literal_count literal_bytes) covering the element, stopping as soon as
+// the element is covered.
+
+class Writer {
+    LargeVector<std::uint8_t> &m_out;
+    EntityId m_previous_id{0};
+
+public:
+    explicit Writer(LargeVector<std::uint8_t> &out) : m_out(out) {}
+
+    void write_varint(std::uint64_t value) {
+        while (value >= 0x80u) {
+            m_out.push(static_cast<std::uint8_t>(value | 0x80u));
+            value >>= 7u;
+        }
+        m_out.push(static_cast<std::uint8_t>(value));
+    }
+
+    void write_id(EntityId id) {
+        const auto delta = static_cast<std::int64_t>(id - m_previous_id);
+        write_varint((static_cast<std::uint64_t>(delta) << 1u) ^ static_cast<std::uint64_t>(delta >> 63));
+        m_previous_id = id;
+    }
+
+    void write_xor(const std::uint8_t *base, const std::uint8_t *current, std::size_t size) {
+        auto byte_at = [&](std::size_t offset) {
+            return static_cast<std::uint8_t>((base != nullptr ? base[offset] : 0u) ^ current[offset]);
+        };
+        std::size_t offset = 0;
+        while (true) {
+            const std::size_t zero_start = offset;
+            while (offset < size && byte_at(offset) == 0) {
+                offset++;
+            }
+            write_varint(offset - zero_start);
+            if (offset == size) {
+                break;
+            }
+            const std::size_t literal_start = offset;
+            while (offset < size && byte_at(offset) != 0) {
+                offset++;
+            }
+            write_varint(offset - literal_start);
+            for (std::size_t i = literal_start; i < offset; i++) {
+                m_out.push(byte_at(i));
+            }
+            if (offset == size) {
+                break;
+            }
+        }
+    }
+
+    void reset_ids() { m_previous_id = 0; }
+};
+
+class Reader {
+    LargeSpan<const std::uint8_t> m_data;
+    std::size_t m_offset{0};
+    EntityId m_previous_id{0};
+    bool m_valid{true};
+
+public:
+    explicit Reader(LargeSpan<const std::uint8_t> data) : m_data(data) {}
+
+    std::uint64_t read_varint() {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (m_offset == m_data.size()) {
+                m_valid = false;
+                return 0;
+            }
+            const std::uint8_t byte = m_data[m_offset++];
+            value |= static_cast<std::uint64_t>(byte & 0x7fu) << shift;
+            if ((byte & 0x80u) == 0) {
+                return value;
+            }
+        }
+        m_valid = false;
+        return 0;
+    }
+
+    EntityId read_id() {
+        const auto zigzag = read_varint();
+        const auto delta = static_cast<std::int64_t>(zigzag >> 1u) ^ -static_cast<std::int64_t>(zigzag & 1u);
+        m_previous_id += static_cast<EntityId>(delta);
+        return m_previous_id;
+    }
+
+    // XORs the encoded runs into `target`.
+    void read_xor(std::uint8_t *target, std::size_t size) {
+        std::size_t offset = 0;
+        while (m_valid) {
+            offset += read_varint();
+            if (offset >= size) {
+                m_valid &= offset == size;
+                return;
+            }
+            const auto literal_count = read_varint();
+            if (literal_count > size - offset || literal_count > m_data.size() - m_offset) {
+                m_valid = false;
+                return;
+            }
+            for (std::size_t i = 0; i < literal_count; i++) {
+                target[offset++] ^= m_data[m_offset++];
+            }
+            if (offset == size) {
+                return;
+            }
+        }
+    }
+
+    void reset_ids() { m_previous_id = 0; }
+    bool valid() const { return m_valid; }
+};
+
+} // namespace
+
+void WorldSnapshot::encode_diff(const EntityManager &manager, LargeVector<std::uint8_t> &diff) const {
+    V2D_ASSERT(manager.m_hibernated.empty(), "Can't diff a manager with hibernated entities");
+    Writer writer(diff);
+    writer.write_varint(manager.m_count);
+    writer.write_varint(manager.m_next_id);
+
+    std::size_t set_count = 0;
+    for (std::size_t i = 0; i < m_sets.size(); i++) {
+        set_count += manager.m_component_infos[i].trivially_copyable ? 1 : 0;
+    }
+    writer.write_varint(set_count);
+
+    for (std::size_t i = 0; i < m_sets.size(); i++) {
+        const auto &info = manager.m_component_infos[i];
+        if (!info.trivially_copyable) {
+            continue;
+        }
+        const auto &set = manager.m_component_sets[i].as<std::byte>();
+        const auto &base = m_sets[i];
+        const EntityId base_size = base.captured ? base.size : 0;
+        const EntityId base_sparse_size = base.captured ? base.sparse_size : 0;
+        const auto *base_dense = reinterpret_cast<const EntityId *>(base.dense.bytes.data());
+        const auto *base_sparse = reinterpret_cast<const EntityId *>(base.sparse.bytes.data());
+        const auto *base_storage = reinterpret_cast<const std::uint8_t *>(base.storage.bytes.data());
+        auto base_index = [&](EntityId id) {
+            if (id < base_sparse_size && base_sparse[id] < base_size && base_dense[base_sparse[id]] == id) {
+                return base_sparse[id];
+            }
+            return k_null_entity;
+        };
+
+        writer.write_varint(i);
+        writer.write_varint(info.size);
+
+        std::size_t removed_count = 0;
+        for (EntityId j = 0; j < base_size; j++) {
+            removed_count += set.contains(base_dense[j]) ? 0 : 1;
+        }
+        writer.write_varint(removed_count);
+        writer.reset_ids();
+        for (EntityId j = 0; j < base_size; j++) {
+            if (!set.contains(base_dense[j])) {
+                writer.write_id(base_dense[j]);
+            }
+        }
+
+        const auto *storage = reinterpret_cast<const std::uint8_t *>(set.storage().data());
+        std::size_t upserted_count = 0;
+        for (EntityId j = 0; j < set.size(); j++) {
+            const auto index = base_index(set.dense()[j]);
+            if (index == k_null_entity ||
+                std::memcmp(base_storage + index * info.size, storage + j * info.size, info.size) != 0) {
+                upserted_count++;
+            }
+        }
+        writer.write_varint(upserted_count);
+        writer.reset_ids();
+        for (EntityId j = 0; j < set.size(); j++) {
+            const auto index = base_index(set.dense()[j]);
+            const auto *current = storage + j * info.size;
+            const auto *previous = index != k_null_entity ? base_storage + index * info.size : nullptr;
+            if (previous == nullptr || std::memcmp(previous, current, info.size) != 0) {
+                writer.write_id(set.dense()[j]);
+                writer.write_xor(previous, current, info.size);
+            }
+        }
+    }
+}
+
+bool WorldSnapshot::apply_diff(EntityManager &manager, LargeSpan<const std::uint8_t> diff) {
+    // Parse the whole diff without touching the manager first, so that a truncated or mismatched diff leaves it as it
+    // was, then apply it in a second pass. Inserted components are decoded into scratch, which is aligned like the
+    // component storage itself.
+    if (!manager.m_hibernated.empty()) {
+        return false;
+    }
+    Vector<std::byte, std::size_t, SparseSet<std::byte, EntityId>::k_storage_alignment> scratch;
+    for (bool commit : {false, true}) {
+        Reader reader(diff);
+        const auto entity_count = reader.read_varint();
+        const auto next_id = reader.read_varint();
+        const auto set_count = reader.read_varint();
+
+        // Sparse arrays are sized by the largest id, so bound ids in the same way as loading a snapshot does.
+        if (!reader.valid() || next_id > UINT32_MAX || entity_count > next_id) {
+            return false;
+        }
+        for (std::uint64_t i = 0; i < set_count && reader.valid(); i++) {
+            const auto component_id = reader.read_varint();
+            const auto element_size = reader.read_varint();
+            if (!reader.valid() || component_id >= manager.m_component_sets.size()) {
+                return false;
+            }
+            const auto &info = manager.m_component_infos[component_id];
+            if (!info.trivially_copyable || info.size != element_size) {
+                return false;
+            }
+            auto &set = manager.m_component_sets[component_id];
+            auto &bytes = set.as<std::byte>();
+
+            const auto removed_count = reader.read_varint();
+            reader.reset_ids();
+            for (std::uint64_t j = 0; j < removed_count && reader.valid(); j++) {
+                const auto id = reader.read_id();
+                if (!commit && !bytes.contains(id)) {
+                    return false;
+                }
+                // An id removed twice passes validation, so check again rather than assume it is still there.
+                if (commit && bytes.contains(id)) {
+                    info.remove(manager, id);
+                }
+            }
+
+            const auto upserted_count = reader.read_varint();
+            reader.reset_ids();
+            for (std::uint64_t j = 0; j < upserted_count && reader.valid(); j++) {
+                const auto id = reader.read_id();
+                if (id >= next_id) {
+                    return false;
+                }
+                if (commit && bytes.contains(id)) {
+                    // The byte view has a stride of one, so compute the address with the real element size.
+                    const auto offset = static_cast<std::size_t>(bytes.sparse()[id]) * info.size;
+                    reader.read_xor(reinterpret_cast<std::uint8_t *>(bytes.untracked_storage() + offset), info.size);
+                    for (auto page = offset / k_page_size; page <= (offset + info.size - 1) / k_page_size; page++) {
+                        bytes.mark_page_dirty(static_cast<std::uint32_t>(page));
+                    }
+                    continue;
+                }
+                scratch.clear();
+                scratch.ensure_size(info.size);
+                reader.read_xor(reinterpret_cast<std::uint8_t *>(scratch.data()), info.size);
+                if (commit) {
+                    info.insert(set, id, scratch.data());
+                }
+            }
+        }
+        if (!reader.valid()) {
+            return false;
+        }
+        if (commit) {
+            manager.m_count = entity_count;
+            manager.m_next_id = next_id;
+        }
+    }
+    manager.m_hierarchy_dirty = true;
+    manager.m_hierarchy_version++;
+    return true;
+}
+
+} // namespace v2d
@@ -1,7 +1,25 @@
 #include <v2d/ecs/Entity.hh>
 
+#include <v2d/ecs/Hierarchy.hh>
+
 namespace v2d {
 
+float ComponentStats::fragmentation() const {
+    if (reserved_bytes() == 0) {
+        return 0.0f;
+    }
+    const auto wasted_bytes = wasted_sparse_slots * sizeof(EntityId);
+    return 1.0f - static_cast<float>(used_bytes() - wasted_bytes) / static_cast<float>(reserved_bytes());
+}
+
+void Entity::set_parent(Entity parent) {
+    m_manager->set_parent(m_id, parent.id());
+}
+
+void Entity::remove_parent() {
+    m_manager->remove_parent(m_id);
+}
+
 void Entity::destroy() {
     m_manager->destroy_entity(m_id);
 }
@@ -9,16 +27,252 @@ void Entity::destroy() {
 Entity EntityManager::create_entity() {
     // TODO: Entity id recycling.
     m_count++;
-    return {m_next_id++, this};
+    return {m_next_id.fetch_add(1, std::memory_order_relaxed), this};
+}
+
+EntityId EntityManager::reserve_entities(EntityId count) {
+    // Ids only need to be unique, so no ordering with other memory is required.
+    m_reserved_count.fetch_add(count, std::memory_order_relaxed);
+    return m_next_id.fetch_add(count, std::memory_order_relaxed);
+}
+
+void EntityManager::materialise_entities() {
+    m_count += m_reserved_count.exchange(0, std::memory_order_relaxed);
 }
 
 void EntityManager::destroy_entity(EntityId id) {
+    EntityId hibernated_root = k_null_entity;
+    if (is_hibernated(id)) {
+        // The entity may be a child in a hibernated tree, in which case the whole tree has to be woken so that its
+        // links point into the hot set before it is unlinked. What is left of the tree is hibernated again afterwards.
+        const auto &cold_hierarchy = m_cold_sets[Hierarchy::component_id].as<Hierarchy>();
+        hibernated_root = id;
+        if (cold_hierarchy.contains(hibernated_root)) {
+            while (!cold_hierarchy[hibernated_root].is_root()) {
+                hibernated_root = cold_hierarchy[hibernated_root].parent();
+            }
+        }
+        wake_tree(hibernated_root);
+    }
+    if (!has_component<Hierarchy>(id)) {
+        erase(id);
+        return;
+    }
+
+    // Children are destroyed along with their parent, so collect the whole subtree first.
+    unlink(id);
+    Vector<EntityId, EntityId> subtree;
+    collect_subtree(m_component_sets[Hierarchy::component_id].as<Hierarchy>(), id, subtree);
+    for (EntityId doomed : subtree) {
+        erase(doomed);
+    }
+    m_hierarchy_dirty = true;
+    if (hibernated_root != k_null_entity && hibernated_root != id) {
+        hibernate_entity(hibernated_root);
+    }
+}
+
+void EntityManager::collect_subtree(const SparseSet<Hierarchy, EntityId> &hierarchy, EntityId root,
+                                    Vector<EntityId, EntityId> &subtree) const {
+    subtree.push(root);
+    for (EntityId i = 0; i < subtree.size(); i++) {
+        for (EntityId child = hierarchy[subtree[i]].first_child(); child != k_null_entity;
+             child = hierarchy[child].next_sibling()) {
+            subtree.push(child);
+        }
+    }
+}
+
+void EntityManager::erase(EntityId id) {
     m_count--;
-    for (auto &set : m_component_sets) {
-        if (set.as<std::byte>().contains(id)) {
-            set.as<std::byte>().remove(id);
+    for (std::size_t i = 0; i < m_component_sets.size(); i++) {
+        if (m_component_sets[i].as<std::byte>().contains(id)) {
+            m_component_infos[i].remove(*this, id);
+        }
+    }
+}
+
+void EntityManager::unlink(EntityId id) {
+    auto &hierarchy = m_component_sets[Hierarchy::component_id].as<Hierarchy>();
+    if (hierarchy[id].m_parent == k_null_entity) {
+        return;
+    }
+    auto &node = hierarchy.get_mut(id);
+    if (node.m_prev_sibling != k_null_entity) {
+        hierarchy.get_mut(node.m_prev_sibling).m_next_sibling = node.m_next_sibling;
+    } else {
+        hierarchy.get_mut(node.m_parent).m_first_child = node.m_next_sibling;
+    }
+    if (node.m_next_sibling != k_null_entity) {
+        hierarchy.get_mut(node.m_next_sibling).m_prev_sibling = node.m_prev_sibling;
+    }
+    node.m_parent = k_null_entity;
+    node.m_prev_sibling = k_null_entity;
+    node.m_next_sibling = k_null_entity;
+}
+
+void EntityManager::freeze(EntityId id) {
+    std::uint16_t mask = 0;
+    for (std::size_t i = 0; i < m_component_sets.size(); i++) {
+        if (m_component_sets[i].as<std::byte>().contains(id)) {
+            m_component_infos[i].transfer(m_component_sets[i], m_cold_sets[i], id);
+            mask |= static_cast<std::uint16_t>(1u << i);
+        }
+    }
+    m_hibernated.insert(id, mask);
+}
+
+void EntityManager::thaw(EntityId id) {
+    const auto mask = m_hibernated[id];
+    for (std::size_t i = 0; i < m_component_sets.size(); i++) {
+        if ((mask & (1u << i)) != 0) {
+            m_component_infos[i].transfer(m_cold_sets[i], m_component_sets[i], id);
+        }
+    }
+    m_hibernated.remove(id);
+}
+
+void EntityManager::hibernate_entity(EntityId id) {
+    V2D_ASSERT(!is_hibernated(id));
+    if (!has_component<Hierarchy>(id)) {
+        freeze(id);
+        return;
+    }
+    V2D_ASSERT(get_component<Hierarchy>(id).is_root(), "Only whole trees can be hibernated");
+    Vector<EntityId, EntityId> subtree;
+    collect_subtree(m_component_sets[Hierarchy::component_id].as<Hierarchy>(), id, subtree);
+    for (EntityId frozen : subtree) {
+        freeze(frozen);
+    }
+    m_hierarchy_dirty = true;
+}
+
+void EntityManager::wake_entity(EntityId id) {
+    V2D_ASSERT(is_hibernated(id));
+    V2D_ASSERT(!m_cold_sets[Hierarchy::component_id].as<Hierarchy>().contains(id) ||
+                   m_cold_sets[Hierarchy::component_id].as<Hierarchy>()[id].is_root(),
+               "Only whole trees can be woken");
+    wake_tree(id);
+}
+
+void EntityManager::wake_tree(EntityId root) {
+    const auto &cold_hierarchy = m_cold_sets[Hierarchy::component_id].as<Hierarchy>();
+    if (!cold_hierarchy.contains(root)) {
+        thaw(root);
+        return;
+    }
+    Vector<EntityId, EntityId> subtree;
+    collect_subtree(cold_hierarchy, root, subtree);
+    for (EntityId frozen : subtree) {
+        thaw(frozen);
+    }
+    m_hierarchy_dirty = true;
+}
+
+void EntityManager::hibernate_entities(Span<const EntityId> ids) {
+    for (EntityId id : ids) {
+        hibernate_entity(id);
+    }
+}
+
+void EntityManager::wake_entities(Span<const EntityId> ids) {
+    for (EntityId id : ids) {
+        wake_entity(id);
+    }
+}
+
+void EntityManager::set_allocator(Allocator *allocator) {
+    for (std::size_t i = 0; i < m_component_sets.size(); i++) {
+        m_component_sets[i].as<std::byte>().set_allocator(allocator);
+        m_cold_sets[i].as<std::byte>().set_allocator(allocator);
+    }
+    m_hibernated.set_allocator(allocator);
+}
+
+ComponentStats EntityManager::component_stats(std::size_t component_id) const {
+    const auto &set = m_component_sets[component_id].as<std::byte>();
+    const auto element_size = m_component_infos[component_id].size;
+    return {
+        .dense{set.dense().size_bytes(), set.dense().capacity() * sizeof(EntityId)},
+        .sparse{set.sparse().size_bytes(), set.sparse().capacity() * sizeof(EntityId)},
+        .storage{set.size() * element_size, set.storage().capacity() * element_size},
+        .count = set.size(),
+        .wasted_sparse_slots = set.sparse().size() - set.size(),
+    };
+}
+
+void EntityManager::set_parent(EntityId child, EntityId parent) {
+    V2D_ASSERT(child != parent);
+    V2D_ASSERT(!is_hibernated(child) && !is_hibernated(parent), "Hibernated entities can't be reparented");
+    if (!has_component<Hierarchy>(child)) {
+        add_component<Hierarchy>(child);
+    }
+    if (!has_component<Hierarchy>(parent)) {
+        add_component<Hierarchy>(parent);
+    }
+
+    auto &hierarchy = m_component_sets[Hierarchy::component_id].as<Hierarchy>();
+    for (EntityId ancestor = parent; ancestor != k_null_entity; ancestor = hierarchy[ancestor].parent()) {
+        V2D_ENSURE(ancestor != child, "Parenting would create a cycle");
+    }
+
+    unlink(child);
+    auto &node = hierarchy.get_mut(child);
+    auto &parent_node = hierarchy.get_mut(parent);
+    node.m_parent = parent;
+    node.m_next_sibling = parent_node.m_first_child;
+    if (parent_node.m_first_child != k_null_entity) {
+        hierarchy.get_mut(parent_node.m_first_child).m_prev_sibling = child;
+    }
+    parent_node.m_first_child = child;
+    m_hierarchy_dirty = true;
+}
+
+void EntityManager::remove_parent(EntityId child) {
+    if (has_component<Hierarchy>(child)) {
+        unlink(child);
+        m_hierarchy_dirty = true;
+    }
+}
+
+void EntityManager::sort_hierarchy() {
+    if (!m_hierarchy_dirty) {
+        return;
+    }
+    m_hierarchy_dirty = false;
+
+    // Lay the set out in depth-first pre-order, recomputing depths on the way. The walk is iterative and only follows
+    // the intrusive links, so no auxiliary stack is needed.
+    auto &hierarchy = m_component_sets[Hierarchy::component_id].as<Hierarchy>();
+    Vector<EntityId, EntityId> order;
+    order.ensure_capacity(hierarchy.size());
+    for (auto *root = hierarchy.dense_begin(); root != hierarchy.dense_end(); ++root) {
+        if (!hierarchy[*root].is_root()) {
+            continue;
+        }
+        EntityId id = *root;
+        std::uint32_t depth = 0;
+        while (true) {
+            auto &node = hierarchy.get_mut(id);
+            node.m_depth = depth;
+            order.push(id);
+            if (node.m_first_child != k_null_entity) {
+                id = node.m_first_child;
+                depth++;
+                continue;
+            }
+            while (id != *root && hierarchy[id].m_next_sibling == k_null_entity) {
+                id = hierarchy[id].m_parent;
+                depth--;
+            }
+            if (id == *root) {
+                break;
+            }
+            id = hierarchy[id].m_next_sibling;
         }
     }
+    hierarchy.arrange(order);
+    m_hierarchy_version++;
 }
 
 } // namespace v2d
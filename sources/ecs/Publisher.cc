@@ -0,0 +1,53 @@
+#include <v2d/ecs/Publisher.hh>
+
+#include <v2d/support/Assert.hh>
+
+#include <algorithm>
+#include <cstring>
+
+namespace v2d {
+
+void ComponentPublisher::publish(EntityManager &manager) {
+    for (std::size_t i = 0; i < m_sets.size(); i++) {
+        if (!m_sets[i]) {
+            continue;
+        }
+        auto &published = *m_sets[i];
+        auto &set = manager.m_component_sets[i].as<std::byte>();
+        auto &buffer = published.buffers[published.write_index];
+        const auto storage_size = set.size() * manager.m_component_infos[i].size;
+        if (buffer.version != set.version()) {
+            buffer.dense.assign(set.dense().data(), set.dense().size());
+            buffer.sparse.assign(set.sparse().data(), set.sparse().size());
+            buffer.storage.assign(set.storage().data(), storage_size);
+            buffer.version = set.version();
+        } else {
+            // Storage is the same size as when this buffer was last filled, so only the pages written since then
+            // differ.
+            const auto page_epochs = set.page_epochs();
+            for (std::uint32_t page = 0; page < page_epochs.size(); page++) {
+                const auto offset = page * SparseSet<std::byte, EntityId>::k_page_size;
+                if (page_epochs[page] > buffer.synced_epoch && offset < storage_size) {
+                    const auto length = std::min(SparseSet<std::byte, EntityId>::k_page_size, storage_size - offset);
+                    std::memcpy(buffer.storage.data() + offset, set.storage().data() + offset, length);
+                }
+            }
+        }
+        buffer.synced_epoch = set.advance_epoch();
+
+        // Release so that the reader sees the buffer contents once it sees the new index.
+        const auto previous = published.latest.exchange(published.write_index | k_fresh, std::memory_order_acq_rel);
+        published.write_index = previous & ~k_fresh;
+    }
+}
+
+const ComponentPublisher::Buffer &ComponentPublisher::acquire(std::size_t component_id) {
+    V2D_ASSERT(m_sets[component_id], "Component isn't published");
+    auto &published = *m_sets[component_id];
+    if ((published.latest.load(std::memory_order_relaxed) & k_fresh) != 0) {
+        published.read_index = published.latest.exchange(published.read_index, std::memory_order_acq_rel) & ~k_fresh;
+    }
+    return published.buffers[published.read_index];
+}
+
+} // namespace v2d
@@ -0,0 +1,203 @@
+#include <v2d/ecs/Entity.hh>
+
+#include <v2d/support/Array.hh>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+
+namespace v2d {
+namespace {
+
+// Every array is stored as its own block, aligned so that it can be bulk copied straight out of the mapping.
+constexpr std::size_t k_block_alignment = 64;
+constexpr std::uint32_t k_magic = 0x57443256; // V2DW
+constexpr std::uint32_t k_version = 1;
+
+struct FileHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t entity_count;
+    std::uint64_t next_id;
+    std::uint32_t set_count;
+    std::uint32_t padding;
+};
+
+struct SetHeader {
+    std::uint32_t component_id;
+    std::uint32_t element_size;
+    std::uint64_t dense_size;
+    std::uint64_t sparse_size;
+};
+
+constexpr std::size_t align_up(std::size_t value) {
+    return (value + k_block_alignment - 1) & ~(k_block_alignment - 1);
+}
+
+bool write_block(std::FILE *file, const void *data, std::size_t size) {
+    const Array<std::byte, k_block_alignment> padding{};
+    const auto position = static_cast<std::size_t>(std::ftell(file));
+    if (std::fwrite(padding.data(), 1, align_up(position) - position, file) != align_up(position) - position) {
+        return false;
+    }
+    return size == 0 || std::fwrite(data, 1, size, file) == size;
+}
+
+// Bounds-checked cursor over the mapped file.
+class Reader {
+    const std::byte *m_data;
+    std::size_t m_size;
+    std::size_t m_offset{0};
+
+public:
+    Reader(const void *data, std::size_t size) : m_data(static_cast<const std::byte *>(data)), m_size(size) {}
+
+    const void *read_block(std::size_t size) {
+        m_offset = align_up(m_offset);
+        if (m_offset > m_size || size > m_size - m_offset) {
+            return nullptr;
+        }
+        const auto *block = m_data + m_offset;
+        m_offset += size;
+        return block;
+    }
+};
+
+} // namespace
+
+bool EntityManager::save(const char *path) const {
+    // Hibernated components live outside of the component sets, so they would be lost.
+    if (!m_hibernated.empty()) {
+        return false;
+    }
+    std::FILE *file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    FileHeader header{
+        .magic = k_magic,
+        .version = k_version,
+        .entity_count = m_count,
+        .next_id = m_next_id,
+        .set_count = 0,
+        .padding = 0,
+    };
+    for (std::size_t i = 0; i < m_component_sets.size(); i++) {
+        if (m_component_infos[i].trivially_copyable && !m_component_sets[i].as<std::byte>().empty()) {
+            header.set_count++;
+        }
+    }
+
+    bool success = write_block(file, &header, sizeof(FileHeader));
+    for (std::size_t i = 0; i < m_component_sets.size() && success; i++) {
+        const auto &info = m_component_infos[i];
+        const auto &set = m_component_sets[i].as<std::byte>();
+        if (!info.trivially_copyable || set.empty()) {
+            continue;
+        }
+        SetHeader set_header{
+            .component_id = static_cast<std::uint32_t>(i),
+            .element_size = static_cast<std::uint32_t>(info.size),
+            .dense_size = set.size(),
+            .sparse_size = set.sparse().size(),
+        };
+        success = write_block(file, &set_header, sizeof(SetHeader)) &&
+                  write_block(file, set.dense().data(), set.dense().size_bytes()) &&
+                  write_block(file, set.sparse().data(), set.sparse().size_bytes()) &&
+                  write_block(file, set.storage().data(), set.size() * info.size);
+    }
+    return std::fclose(file) == 0 && success;
+}
+
+bool EntityManager::load(const char *path) {
+    if (m_next_id != 0) {
+        return false;
+    }
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    const auto file_size = static_cast<std::size_t>(file_stat.st_size);
+    void *mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(mapping, file_size, MADV_SEQUENTIAL);
+
+    // Validate the whole file before touching any state so that a truncated or mismatched snapshot leaves the manager
+    // empty, then bulk copy each block out of the mapping in a second pass.
+    bool valid = true;
+    for (bool commit : {false, true}) {
+        Reader reader(mapping, file_size);
+        const auto *header = static_cast<const FileHeader *>(reader.read_block(sizeof(FileHeader)));
+        valid = header != nullptr && header->magic == k_magic && header->version == k_version &&
+                header->next_id <= UINT32_MAX && header->entity_count <= header->next_id;
+        // Each set may only appear once, since a second block would silently replace the first.
+        std::uint16_t seen_sets = 0;
+        for (std::uint32_t i = 0; valid && i < header->set_count; i++) {
+            const auto *set_header = static_cast<const SetHeader *>(reader.read_block(sizeof(SetHeader)));
+            valid = set_header != nullptr && set_header->component_id < m_component_sets.size() &&
+                    (seen_sets & (1u << set_header->component_id)) == 0;
+            if (!valid) {
+                break;
+            }
+            seen_sets |= static_cast<std::uint16_t>(1u << set_header->component_id);
+            // Component storage is indexed by 32-bit sizes, and bounding both arrays here also means that none of the
+            // block sizes below can overflow.
+            valid = set_header->dense_size <= UINT32_MAX && set_header->sparse_size <= UINT32_MAX;
+            if (!valid) {
+                break;
+            }
+            const auto &info = m_component_infos[set_header->component_id];
+            const auto dense_size = static_cast<EntityId>(set_header->dense_size);
+            const auto sparse_size = static_cast<EntityId>(set_header->sparse_size);
+            const auto *dense = static_cast<const EntityId *>(reader.read_block(dense_size * sizeof(EntityId)));
+            const auto *sparse = static_cast<const EntityId *>(reader.read_block(sparse_size * sizeof(EntityId)));
+            const auto *storage = reader.read_block(set_header->dense_size * set_header->element_size);
+            valid = info.assign != nullptr && info.trivially_copyable && info.size == set_header->element_size &&
+                    dense != nullptr && sparse != nullptr && storage != nullptr;
+
+            // Every dense entry must be a live id which the sparse array maps back to the same slot, otherwise later
+            // lookups would index out of bounds.
+            for (EntityId j = 0; valid && !commit && j < dense_size; j++) {
+                valid = dense[j] < sparse_size && dense[j] < header->next_id && sparse[dense[j]] == j;
+            }
+            if (valid && commit) {
+                info.assign(m_component_sets[set_header->component_id], dense, storage, dense_size, sparse,
+                            sparse_size);
+            }
+        }
+        if (!valid) {
+            break;
+        }
+        if (commit) {
+            m_count = header->entity_count;
+            m_next_id = header->next_id;
+        }
+    }
+    ::munmap(mapping, file_size);
+    if (!valid) {
+        return false;
+    }
+
+    // The loaded hierarchy may be in any order, so sort it again on the next update and force dependent systems to
+    // rebuild anything derived from the old order.
+    m_hierarchy_dirty = true;
+    m_hierarchy_version++;
+    return true;
+}
+
+} // namespace v2d
@@ -0,0 +1,129 @@
+#include <v2d/ecs/Snapshot.hh>
+
+#include <algorithm>
+#include <cstring>
+
+namespace v2d {
+namespace {
+
+std::size_t page_count(std::size_t size) {
+    return (size + WorldSnapshot::k_page_size - 1) / WorldSnapshot::k_page_size;
+}
+
+// Copies the pages of `src` which were written after `epoch`, calling `on_copy` with each page index. Returns how many
+// were copied.
+template <typename F>
+std::size_t copy_pages(std::byte *dst, const std::byte *src, std::size_t size, Span<const std::size_t> page_epochs,
+                       std::size_t epoch, F on_copy) {
+    std::size_t written_pages = 0;
+    const auto count = std::min<std::size_t>(page_epochs.size(), page_count(size));
+    for (std::uint32_t page = 0; page < count; page++) {
+        if (page_epochs[page] <= epoch) {
+            continue;
+        }
+        const auto offset = page * WorldSnapshot::k_page_size;
+        std::memcpy(dst + offset, src + offset, std::min(WorldSnapshot::k_page_size, size - offset));
+        on_copy(page);
+        written_pages++;
+    }
+    return written_pages;
+}
+
+const std::byte *as_bytes(const EntityId *data) {
+    return reinterpret_cast<const std::byte *>(data);
+}
+
+} // namespace
+
+bool WorldSnapshot::capture(EntityManager &manager) {
+    if (!manager.m_hibernated.empty()) {
+        return false;
+    }
+    for (const auto &info : manager.m_component_infos) {
+        if (info.remove != nullptr && !info.trivially_copyable) {
+            return false;
+        }
+    }
+
+    m_written_pages = 0;
+    auto capture_block = [this](Block &block, const std::byte *data, std::size_t size) {
+        block.bytes.ensure_size(size);
+        block.size = size;
+        if (size != 0) {
+            std::memcpy(block.bytes.data(), data, size);
+        }
+        m_written_pages += page_count(size);
+    };
+    for (std::size_t i = 0; i < m_sets.size(); i++) {
+        // Unregistered sets are empty, and the element size doesn't matter for an empty set.
+        const auto element_size = manager.m_component_infos[i].size;
+        auto &set = manager.m_component_sets[i].as<std::byte>();
+        auto &snapshot = m_sets[i];
+        const auto storage_size = set.size() * element_size;
+        if (!snapshot.captured || m_source != &manager || snapshot.version != set.version()) {
+            capture_block(snapshot.dense, as_bytes(set.dense().data()), set.dense().size_bytes());
+            capture_block(snapshot.sparse, as_bytes(set.sparse().data()), set.sparse().size_bytes());
+            capture_block(snapshot.storage, set.storage().data(), storage_size);
+            snapshot.size = set.size();
+            snapshot.sparse_size = set.sparse().size();
+            snapshot.version = set.version();
+        } else {
+            m_written_pages += copy_pages(snapshot.storage.bytes.data(), set.storage().data(), storage_size,
+                                          set.page_epochs(), snapshot.synced_epoch, [](std::uint32_t) {});
+        }
+        snapshot.synced_epoch = set.advance_epoch();
+        snapshot.captured = true;
+    }
+    m_source = &manager;
+    m_count = manager.m_count;
+    m_next_id = manager.m_next_id;
+    m_hierarchy_dirty = manager.m_hierarchy_dirty;
+    return true;
+}
+
+bool WorldSnapshot::restore(EntityManager &manager) {
+    V2D_ASSERT(m_source == &manager, "Snapshots must be restored into the manager they were captured from");
+    if (!manager.m_hibernated.empty()) {
+        return false;
+    }
+    for (const auto &info : manager.m_component_infos) {
+        if (info.remove != nullptr && !info.trivially_copyable) {
+            return false;
+        }
+    }
+
+    m_written_pages = 0;
+    for (std::size_t i = 0; i < m_sets.size(); i++) {
+        const auto &info = manager.m_component_infos[i];
+        auto &set = manager.m_component_sets[i];
+        auto &bytes = set.as<std::byte>();
+        auto &snapshot = m_sets[i];
+        if (bytes.version() != snapshot.version) {
+            // Entities were added or removed since the capture, so restore the whole set. A set which was registered
+            // after the capture was empty at the time.
+            if (info.assign != nullptr) {
+                const auto *dense = reinterpret_cast<const EntityId *>(snapshot.dense.bytes.data());
+                const auto *sparse = reinterpret_cast<const EntityId *>(snapshot.sparse.bytes.data());
+                info.assign(set, dense, snapshot.storage.bytes.data(), snapshot.size, sparse, snapshot.sparse_size);
+            }
+            snapshot.version = bytes.version();
+            m_written_pages += page_count(snapshot.dense.size) + page_count(snapshot.sparse.size) +
+                               page_count(snapshot.storage.size);
+        } else {
+            // The pages put back are themselves writes, which other copies of the set need to see.
+            m_written_pages += copy_pages(reinterpret_cast<std::byte *>(bytes.untracked_storage()),
+                                          snapshot.storage.bytes.data(), snapshot.storage.size, bytes.page_epochs(),
+                                          snapshot.synced_epoch, [&bytes](std::uint32_t page) {
+                                              bytes.mark_page_dirty(page);
+                                          });
+        }
+        snapshot.synced_epoch = bytes.advance_epoch();
+    }
+    manager.m_count = m_count;
+    manager.m_next_id = m_next_id;
+    manager.m_hierarchy_dirty = m_hierarchy_dirty;
+    manager.m_hierarchy_version++;
+    return true;
+}
+
+} // namespace v2d
@@ -0,0 +1,77 @@
+#include <v2d/ecs/System.hh>
+
+#include <v2d/support/Assert.hh>
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+namespace v2d {
+
+System &System::run_every(std::uint32_t ticks) {
+    V2D_ASSERT(ticks != 0);
+    m_schedule.interval = ticks;
+    m_schedule.phase = Schedule::k_unassigned_phase;
+    return *this;
+}
+
+System &System::run_at(float hz) {
+    V2D_ASSERT(hz > 0.0f);
+    m_schedule.period = 1.0f / hz;
+    return *this;
+}
+
+void System::Profile::record(float ms, std::size_t allocation_count) {
+    samples[next_sample] = ms;
+    next_sample = (next_sample + 1) % k_sample_count;
+    sample_count = std::min(sample_count + 1, k_sample_count);
+    last_entity_count = std::exchange(entity_count, 0);
+    last_allocation_count = allocation_count;
+}
+
+void SystemManager::set_profiling(bool profiling) {
+    m_profiling = profiling;
+    for (const auto &system : m_systems) {
+        system->m_profile = {};
+    }
+}
+
+SystemStats SystemManager::system_stats(std::uint32_t index) const {
+    const auto &system = *m_systems[index];
+    const auto &profile = system.m_profile;
+    SystemStats stats{
+        .name = system.name(),
+        .min_ms = 0.0f,
+        .average_ms = 0.0f,
+        .p99_ms = 0.0f,
+        .entity_count = profile.last_entity_count,
+        .allocation_count = profile.last_allocation_count,
+    };
+    if (profile.sample_count == 0) {
+        return stats;
+    }
+
+    auto samples = profile.samples;
+    auto *end = samples.begin() + profile.sample_count;
+    stats.min_ms = *std::min_element(samples.begin(), end);
+    for (const float *sample = samples.begin(); sample != end; sample++) {
+        stats.average_ms += *sample;
+    }
+    stats.average_ms /= static_cast<float>(profile.sample_count);
+    auto *p99 = samples.begin() + (profile.sample_count * 99 + 99) / 100 - 1;
+    std::nth_element(samples.begin(), p99, end);
+    stats.p99_ms = *p99;
+    return stats;
+}
+
+void SystemManager::dump_profile() const {
+    std::fprintf(stderr, "%-24s %10s %10s %10s %10s %10s\n", "system", "min ms", "avg ms", "p99 ms", "entities",
+                 "allocs");
+    for (std::uint32_t i = 0; i < system_count(); i++) {
+        const auto stats = system_stats(i);
+        std::fprintf(stderr, "%-24s %10.3f %10.3f %10.3f %10zu %10zu\n", stats.name, stats.min_ms, stats.average_ms,
+                     stats.p99_ms, stats.entity_count, stats.allocation_count);
+    }
+}
+
+} // namespace v2d
@@ -1,11 +1,91 @@
 #include <v2d/ecs/World.hh>
 
+#include <v2d/support/Assert.hh>
+#include <v2d/support/Trace.hh>
+
+#include <chrono>
+#include <cmath>
+#include <utility>
+
 namespace v2d {
 
+bool World::should_run(System &system, float &dt) {
+    auto &schedule = system.m_schedule;
+    if (!schedule.enabled) {
+        return false;
+    }
+    if (schedule.phase == System::Schedule::k_unassigned_phase) {
+        schedule.phase = schedule.interval != 1 ? m_next_phase++ % schedule.interval : 0;
+    }
+    schedule.elapsed += dt;
+    if ((schedule.counter++ + schedule.phase) % schedule.interval != 0 || schedule.elapsed < schedule.period) {
+        return false;
+    }
+    if (schedule.watched_components != 0) {
+        std::size_t version = 0;
+        for (std::size_t i = 0; i < 16; i++) {
+            if ((schedule.watched_components & (1u << i)) != 0) {
+                version += component_version(i);
+            }
+        }
+        // Versions only ever increase, so the sum only stays the same if none of the sets changed.
+        if (version == schedule.watched_version) {
+            return false;
+        }
+        schedule.watched_version = version;
+    }
+    dt = std::exchange(schedule.elapsed, 0.0f);
+    return true;
+}
+
+void World::run_system(System &system, float dt) {
+    if (!should_run(system, dt)) {
+        return;
+    }
+    V2D_TRACE_SCOPE(system.name());
+    if (!m_profiling) {
+        system.update(this, dt);
+        return;
+    }
+
+    const auto allocation_count = allocation_counter();
+    const auto start = std::chrono::steady_clock::now();
+    system.update(this, dt);
+    const auto end = std::chrono::steady_clock::now();
+    system.m_profile.record(std::chrono::duration<float, std::milli>(end - start).count(),
+                            allocation_counter() - allocation_count);
+}
+
 void World::update(float dt) {
+    V2D_TRACE_SCOPE("World::update");
+    materialise_entities();
+    m_accumulator += dt;
+    for (std::uint32_t step = 0; step < m_max_fixed_steps && m_accumulator >= m_fixed_timestep; step++) {
+        for (const auto &system : m_systems) {
+            if (system->m_fixed) {
+                run_system(*system, m_fixed_timestep);
+            }
+        }
+        m_accumulator -= m_fixed_timestep;
+    }
+    if (m_accumulator >= m_fixed_timestep) {
+        m_accumulator = std::fmod(m_accumulator, m_fixed_timestep);
+    }
+
     for (const auto &system : m_systems) {
-        system->update(this, dt);
+        if (!system->m_fixed) {
+            run_system(*system, dt);
+        }
     }
+    swap_events();
+    m_publisher.publish(*this);
+    m_frame_arena.reset();
+}
+
+void World::set_fixed_timestep(float timestep, std::uint32_t max_steps) {
+    V2D_ASSERT(timestep > 0.0f && max_steps > 0);
+    m_fixed_timestep = timestep;
+    m_max_fixed_steps = max_steps;
 }
 
 } // namespace v2d
@@ -5,24 +5,28 @@
 #include <v2d/ecs/World.hh>
 #include <v2d/gfx/Sprite.hh>
 #include <v2d/maths/Vec.hh>
+#include <v2d/support/Trace.hh>
 
 namespace v2d {
 namespace {
 
 struct ObjectData {
-    Vec2f position;
-    Vec2f scale;
+    Vec2f basis_x;
+    Vec2f basis_y;
+    Vec2f translation;
     Vec2f sprite_cell;
 };
 
 } // namespace
 
 void RenderSystem::update(World *world, float) {
+    V2D_TRACE_SCOPE("RenderSystem::update");
     std::size_t object_count = 0;
     for (auto [entity, sprite] : world->view<Sprite>()) {
-        V2D_ASSERT(entity.has<Transform>());
+        V2D_ASSERT(entity.has<WorldTransform>());
         object_count++;
     }
+    count_entities(object_count);
 
     const bool need_more_capacity = object_count > m_object_capacity;
     if (need_more_capacity || object_count < (m_object_capacity / 2)) {
@@ -50,10 +54,11 @@ void RenderSystem::update(World *world, float) {
 
     auto *object_buffer = m_object_buffer.map<ObjectData>();
     for (std::size_t i = 0; auto [entity, sprite] : world->view<Sprite>()) {
-        const auto &transform = entity.get<Transform>();
+        const auto &transform = entity.get<WorldTransform>();
         auto &object_data = object_buffer[i++];
-        object_data.position = transform.position();
-        object_data.scale = transform.scale();
+        object_data.basis_x = transform.basis_x();
+        object_data.basis_y = transform.basis_y();
+        object_data.translation = transform.translation();
         object_data.sprite_cell = {static_cast<float>(sprite->cell().x()), static_cast<float>(sprite->cell().y())};
     }
     m_object_buffer.unmap();
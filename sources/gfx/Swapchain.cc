@@ -2,6 +2,7 @@
 
 #include <v2d/core/Context.hh>
 #include <v2d/core/Window.hh>
+#include <v2d/support/Trace.hh>
 #include <v2d/support/Vector.hh>
 
 #include <limits>
@@ -82,6 +83,7 @@ Swapchain::~Swapchain() {
 }
 
 std::uint32_t Swapchain::acquire_next_image(VkSemaphore semaphore) const {
+    V2D_TRACE_SCOPE("Swapchain::acquire_next_image");
     std::uint32_t image_index = 0;
     vkAcquireNextImageKHR(m_context.device(), m_swapchain, std::numeric_limits<std::uint64_t>::max(), semaphore,
                           nullptr, &image_index);
@@ -89,6 +91,7 @@ std::uint32_t Swapchain::acquire_next_image(VkSemaphore semaphore) const {
 }
 
 void Swapchain::present(std::uint32_t image_index, Span<VkSemaphore> wait_semaphores) const {
+    V2D_TRACE_SCOPE("Swapchain::present");
     VkPresentInfoKHR present_info{
         .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
         .waitSemaphoreCount = wait_semaphores.size(),
@@ -0,0 +1,173 @@
+#include <v2d/support/Allocator.hh>
+
+#include <v2d/support/Assert.hh>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace v2d {
+namespace {
+
+// Every heap allocation is preceded by a header recording how to free it. The header sits directly before the returned
+// pointer, at the end of a prefix which is a multiple of the alignment so that the pointer stays aligned.
+struct AllocationHeader {
+    enum Kind : std::uint32_t {
+        Malloc,
+        Mapping,
+        TransparentHugeMapping,
+        HugeTlbMapping,
+    };
+    // The size of the anonymous mapping, or zero if the allocation came from malloc.
+    std::size_t mapping_size;
+    std::uint32_t prefix_size;
+    Kind kind;
+};
+
+std::size_t page_size() {
+    static const auto size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+constexpr std::size_t align_up(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+AllocationHeader &header_of(void *ptr) {
+    return *(static_cast<AllocationHeader *>(ptr) - 1);
+}
+
+std::uint32_t prefix_size(std::size_t alignment) {
+    V2D_ASSERT(alignment <= page_size(), "Alignment larger than a page");
+    return static_cast<std::uint32_t>(
+        align_up(sizeof(AllocationHeader), std::max(alignment, alignof(std::max_align_t))));
+}
+
+void *place_header(void *base, std::size_t mapping_size, std::uint32_t prefix, AllocationHeader::Kind kind) {
+    void *ptr = static_cast<std::byte *>(base) + prefix;
+    header_of(ptr) = {mapping_size, prefix, kind};
+    return ptr;
+}
+
+void *map_allocation(std::size_t size, std::uint32_t prefix) {
+    const auto mapping_size = align_up(prefix + size, page_size());
+    void *base = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    V2D_ENSURE(base != MAP_FAILED, "Out of memory");
+    return place_header(base, mapping_size, prefix, AllocationHeader::Mapping);
+}
+
+// Maps `size` bytes at an address aligned to `alignment`, by over-mapping and trimming the excess. Transparent huge
+// pages can only back the parts of a mapping which are aligned to the huge page size.
+void *map_aligned(std::size_t size, std::size_t alignment) {
+    void *mapping = ::mmap(nullptr, size + alignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    V2D_ENSURE(mapping != MAP_FAILED, "Out of memory");
+    auto *base = static_cast<std::byte *>(mapping);
+    auto *aligned = reinterpret_cast<std::byte *>(align_up(reinterpret_cast<std::uintptr_t>(base), alignment));
+    if (aligned != base) {
+        ::munmap(base, static_cast<std::size_t>(aligned - base));
+    }
+    if (const auto tail = static_cast<std::size_t>(base + size + alignment - (aligned + size)); tail != 0) {
+        ::munmap(aligned + size, tail);
+    }
+    return aligned;
+}
+
+} // namespace
+
+void *Allocator::reallocate(void *ptr, std::size_t used_size, std::size_t size, std::size_t alignment) {
+    void *new_ptr = allocate(size, alignment);
+    if (used_size != 0) {
+        std::memcpy(new_ptr, ptr, used_size);
+    }
+    deallocate(ptr);
+    return new_ptr;
+}
+
+void *HeapAllocator::allocate(std::size_t size, std::size_t alignment) {
+    const auto prefix = prefix_size(alignment);
+    if (size >= k_mapping_threshold) {
+        return map_allocation(size, prefix);
+    }
+
+    // aligned_alloc requires the size to be a multiple of the alignment, which is a power of two.
+    alignment = std::max(alignment, alignof(std::max_align_t));
+    void *base = std::aligned_alloc(alignment, align_up(prefix + size, alignment));
+    V2D_ENSURE(base != nullptr, "Out of memory");
+    return place_header(base, 0, prefix, AllocationHeader::Malloc);
+}
+
+void HeapAllocator::deallocate(void *ptr) {
+    const auto header = header_of(ptr);
+    void *base = static_cast<std::byte *>(ptr) - header.prefix_size;
+    if (header.kind != AllocationHeader::Malloc) {
+        ::munmap(base, header.mapping_size);
+    } else {
+        std::free(base);
+    }
+}
+
+void *HeapAllocator::reallocate(void *ptr, std::size_t used_size, std::size_t size, std::size_t alignment) {
+    const auto header = header_of(ptr);
+    if (header.kind != AllocationHeader::Mapping || size < k_mapping_threshold ||
+        header.prefix_size != prefix_size(alignment)) {
+        return Allocator::reallocate(ptr, used_size, size, alignment);
+    }
+
+    // The kernel moves the page table entries, so no data is copied and untouched pages stay untouched.
+    void *base = static_cast<std::byte *>(ptr) - header.prefix_size;
+    const auto mapping_size = align_up(header.prefix_size + size, page_size());
+    base = ::mremap(base, header.mapping_size, mapping_size, MREMAP_MAYMOVE);
+    V2D_ENSURE(base != MAP_FAILED, "Out of memory");
+    return place_header(base, mapping_size, header.prefix_size, AllocationHeader::Mapping);
+}
+
+void *HugePageAllocator::allocate(std::size_t size, std::size_t alignment) {
+    if (size < k_huge_threshold) {
+        return heap_allocator().allocate(size, alignment);
+    }
+    const auto prefix = prefix_size(alignment);
+    const auto mapping_size = align_up(prefix + size, k_huge_page_size);
+    if (m_mode == Mode::Explicit) {
+        void *base = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                            -1, 0);
+        if (base != MAP_FAILED) {
+            return place_header(base, mapping_size, prefix, AllocationHeader::HugeTlbMapping);
+        }
+    }
+    void *base = map_aligned(mapping_size, k_huge_page_size);
+    ::madvise(base, mapping_size, MADV_HUGEPAGE);
+    return place_header(base, mapping_size, prefix, AllocationHeader::TransparentHugeMapping);
+}
+
+void HugePageAllocator::deallocate(void *ptr) {
+    heap_allocator().deallocate(ptr);
+}
+
+void *HugePageAllocator::reallocate(void *ptr, std::size_t used_size, std::size_t size, std::size_t alignment) {
+    const auto header = header_of(ptr);
+    if (header.kind != AllocationHeader::TransparentHugeMapping || size < k_huge_threshold ||
+        header.prefix_size != prefix_size(alignment)) {
+        return Allocator::reallocate(ptr, used_size, size, alignment);
+    }
+
+    // Remap into a fresh huge page aligned range, rather than wherever the kernel would put it, to keep the whole
+    // buffer eligible for huge pages.
+    const auto mapping_size = align_up(header.prefix_size + size, k_huge_page_size);
+    void *target = map_aligned(mapping_size, k_huge_page_size);
+    void *base = ::mremap(static_cast<std::byte *>(ptr) - header.prefix_size, header.mapping_size, mapping_size,
+                          MREMAP_MAYMOVE | MREMAP_FIXED, target);
+    V2D_ENSURE(base != MAP_FAILED, "Out of memory");
+    ::madvise(base, mapping_size, MADV_HUGEPAGE);
+    return place_header(base, mapping_size, header.prefix_size, AllocationHeader::TransparentHugeMapping);
+}
+
+Allocator &heap_allocator() {
+    static HeapAllocator allocator;
+    return allocator;
+}
+
+} // namespace v2d
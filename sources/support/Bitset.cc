@@ -0,0 +1,108 @@
+#include <v2d/support/Bitset.hh>
+
+#include <bit>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define V2D_BITSET_AVX2
+#endif
+
+namespace v2d {
+namespace {
+
+template <typename Op>
+void apply_scalar(std::uint64_t *dst, const std::uint64_t *src, std::size_t count, Op op) {
+    for (std::size_t i = 0; i < count; i++) {
+        dst[i] = op(dst[i], src[i]);
+    }
+}
+
+#ifdef V2D_BITSET_AVX2
+bool has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    return supported;
+}
+
+// Four words per iteration, then a scalar tail.
+#define V2D_AVX2_KERNEL(name, vector_op, scalar_op)                                                                    \
+    __attribute__((target("avx2"))) void name(std::uint64_t *dst, const std::uint64_t *src, std::size_t count) {     \
+        std::size_t i = 0;                                                                                             \
+        for (; i + 4 <= count; i += 4) {                                                                               \
+            const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));                            \
+            const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));                            \
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), vector_op);                                      \
+        }                                                                                                              \
+        for (; i < count; i++) {                                                                                       \
+            const auto a = dst[i];                                                                                     \
+            const auto b = src[i];                                                                                     \
+            dst[i] = scalar_op;                                                                                        \
+        }                                                                                                              \
+    }
+
+V2D_AVX2_KERNEL(and_avx2, _mm256_and_si256(a, b), a & b)
+V2D_AVX2_KERNEL(or_avx2, _mm256_or_si256(a, b), a | b)
+V2D_AVX2_KERNEL(and_not_avx2, _mm256_andnot_si256(b, a), a & ~b)
+#undef V2D_AVX2_KERNEL
+
+// AVX2 has no vector popcount, but enabling the target lets the compiler use the popcnt instruction and unroll.
+__attribute__((target("avx2,popcnt"))) std::size_t popcount_avx2(const std::uint64_t *words, std::size_t count) {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        total += static_cast<std::size_t>(std::popcount(words[i]));
+    }
+    return total;
+}
+#endif
+
+} // namespace
+
+void and_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t count) {
+#ifdef V2D_BITSET_AVX2
+    if (has_avx2()) {
+        and_avx2(dst, src, count);
+        return;
+    }
+#endif
+    apply_scalar(dst, src, count, [](std::uint64_t a, std::uint64_t b) {
+        return a & b;
+    });
+}
+
+void or_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t count) {
+#ifdef V2D_BITSET_AVX2
+    if (has_avx2()) {
+        or_avx2(dst, src, count);
+        return;
+    }
+#endif
+    apply_scalar(dst, src, count, [](std::uint64_t a, std::uint64_t b) {
+        return a | b;
+    });
+}
+
+void and_not_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t count) {
+#ifdef V2D_BITSET_AVX2
+    if (has_avx2()) {
+        and_not_avx2(dst, src, count);
+        return;
+    }
+#endif
+    apply_scalar(dst, src, count, [](std::uint64_t a, std::uint64_t b) {
+        return a & ~b;
+    });
+}
+
+std::size_t popcount_words(const std::uint64_t *words, std::size_t count) {
+#ifdef V2D_BITSET_AVX2
+    if (has_avx2()) {
+        return popcount_avx2(words, count);
+    }
+#endif
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        total += static_cast<std::size_t>(std::popcount(words[i]));
+    }
+    return total;
+}
+
+} // namespace v2d
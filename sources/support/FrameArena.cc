@@ -0,0 +1,123 @@
+#include <v2d/support/FrameArena.hh>
+
+#include <v2d/support/Array.hh>
+
+#include <algorithm>
+#include <atomic>
+
+namespace v2d {
+namespace {
+
+// Each frame of each arena is identified by a never-reused id, so that a thread's cached sub-arena can't be mistaken
+// for one belonging to a later frame or to a new arena at the same address.
+std::uint64_t next_arena_id() {
+    static std::atomic<std::uint64_t> id{0};
+    return id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// A thread remembers its sub-arenas of the last few arenas it allocated from, so that alternating between arenas, such
+// as those of two worlds, doesn't claim a fresh sub-arena on every switch.
+constexpr std::uint32_t k_cached_arena_count = 8;
+
+struct LocalCache {
+    struct Entry {
+        std::uint64_t arena_id{0};
+        LinearArena *arena{nullptr};
+    };
+    Array<Entry, k_cached_arena_count> entries{};
+    std::uint32_t next_victim{0};
+};
+
+LocalCache &local_cache() {
+    thread_local LocalCache cache;
+    return cache;
+}
+
+} // namespace
+
+LinearArena::~LinearArena() {
+    for (const auto &block : m_blocks) {
+        heap_allocator().deallocate(block.data);
+    }
+}
+
+void *LinearArena::allocate(std::size_t size, std::size_t alignment) {
+    for (; m_block_index < m_blocks.size(); m_block_index++, m_offset = 0) {
+        const auto &block = m_blocks[m_block_index];
+        const auto address = reinterpret_cast<std::uintptr_t>(block.data) + m_offset;
+        const auto padding = (alignment - address % alignment) % alignment;
+        if (m_offset + padding + size <= block.size) {
+            m_offset += padding + size;
+            return block.data + m_offset - size;
+        }
+    }
+
+    // Oversized allocations get a block of their own, which is kept for reuse like any other.
+    const auto block_size = std::max(m_block_size, size + alignment);
+    m_blocks.push({static_cast<std::byte *>(heap_allocator().allocate(block_size, alignof(std::max_align_t))),
+                   block_size});
+    m_block_index = m_blocks.size() - 1;
+    m_offset = 0;
+    return allocate(size, alignment);
+}
+
+void LinearArena::reset() {
+    m_block_index = 0;
+    m_offset = 0;
+}
+
+std::size_t LinearArena::reserved_bytes() const {
+    std::size_t size = 0;
+    for (const auto &block : m_blocks) {
+        size += block.size;
+    }
+    return size;
+}
+
+FrameArena::FrameArena(std::size_t block_size) : m_block_size(block_size), m_id(next_arena_id()) {}
+
+LinearArena &FrameArena::local() {
+    auto &cache = local_cache();
+    for (const auto &entry : cache.entries) {
+        if (entry.arena_id == m_id) {
+            return *entry.arena;
+        }
+    }
+    // Entries of finished frames never match again, so evicting round robin eventually reuses them all.
+    auto &entry = cache.entries[cache.next_victim];
+    cache.next_victim = (cache.next_victim + 1) % k_cached_arena_count;
+    entry.arena = &acquire_local();
+    entry.arena_id = m_id;
+    return *entry.arena;
+}
+
+LinearArena &FrameArena::acquire_local() {
+    // Sub-arenas are handed out afresh every frame, so there are only ever as many as the most threads that have
+    // allocated in a single frame, even if threads come and go. A thread only claims a second one in a frame if it
+    // allocates from more arenas in between than its cache holds.
+    std::scoped_lock lock(m_mutex);
+    if (m_used_arenas == m_arenas.size()) {
+        m_arenas.emplace(new LinearArena(m_block_size));
+    }
+    return *m_arenas[m_used_arenas++];
+}
+
+void FrameArena::reset() {
+    std::scoped_lock lock(m_mutex);
+    for (std::uint32_t i = 0; i < m_used_arenas; i++) {
+        m_arenas[i]->reset();
+    }
+    m_used_arenas = 0;
+    m_id = next_arena_id();
+}
+
+std::size_t FrameArena::reserved_bytes() {
+    std::scoped_lock lock(m_mutex);
+    std::size_t size = 0;
+    for (const auto &arena : m_arenas) {
+        size += arena->reserved_bytes();
+    }
+    return size;
+}
+
+} // namespace v2d
@@ -0,0 +1,262 @@
+#include <v2d/support/JobSystem.hh>
+
+#include <v2d/support/Assert.hh>
+
+namespace v2d {
+namespace {
+
+// Fixed-capacity Chase-Lev deque, using the C11 memory model formulation from Lê et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models". Only the owning worker pushes and pops at the bottom; any worker can steal
+// from the top. Every store to the bottom is a release, rather than only the one in push being preceded by a release
+// fence, so that thieves reading any bottom value see the job written before it.
+template <typename T>
+class WorkStealingDeque {
+    static constexpr std::int64_t k_capacity = JobSystem::k_max_jobs;
+
+    Array<std::atomic<T *>, k_capacity> m_buffer{};
+    alignas(k_cache_line_size) std::atomic<std::int64_t> m_top{0};
+    alignas(k_cache_line_size) std::atomic<std::int64_t> m_bottom{0};
+
+    std::atomic<T *> &slot(std::int64_t index) {
+        return m_buffer[static_cast<std::uint32_t>(index & (k_capacity - 1))];
+    }
+
+public:
+    // Returns false if the deque is full.
+    bool push(T *elem);
+    T *pop();
+    T *steal();
+};
+
+template <typename T>
+bool WorkStealingDeque<T>::push(T *elem) {
+    const auto bottom = m_bottom.load(std::memory_order_relaxed);
+    const auto top = m_top.load(std::memory_order_acquire);
+    if (bottom - top >= k_capacity) {
+        return false;
+    }
+    slot(bottom).store(elem, std::memory_order_relaxed);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+T *WorkStealingDeque<T>::pop() {
+    const auto bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = m_top.load(std::memory_order_relaxed);
+    if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return nullptr;
+    }
+    auto *elem = slot(bottom).load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // Last element, race any thieves for it.
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            elem = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+    return elem;
+}
+
+template <typename T>
+T *WorkStealingDeque<T>::steal() {
+    auto top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return nullptr;
+    }
+    auto *elem = slot(top).load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return elem;
+}
+
+struct CurrentWorker {
+    const JobSystem *system{nullptr};
+    std::uint32_t index{0};
+};
+
+CurrentWorker &current_worker() {
+    thread_local CurrentWorker worker;
+    return worker;
+}
+
+// Spins before going to sleep, since new work usually turns up soon after a worker runs out.
+constexpr std::uint32_t k_idle_spin_count = 64;
+
+} // namespace
+
+struct JobSystem::Worker {
+    WorkStealingDeque<Job> deque;
+    Array<Job, k_max_jobs> jobs;
+    // Jobs which this worker has allocated are returned to its private free list if it finished them itself, or
+    // otherwise pushed onto the returned list by whichever worker did. Only the owner takes from the returned list,
+    // and it takes the whole list at once, so there is no ABA problem.
+    Job *free_list{nullptr};
+    alignas(k_cache_line_size) std::atomic<Job *> returned{nullptr};
+    std::uint32_t random_state;
+
+    explicit Worker(std::uint32_t index) : random_state(index * 0x9e3779b9u + 1) {
+        for (auto &job : jobs) {
+            job.owner = index;
+            job.next = std::exchange(free_list, &job);
+        }
+    }
+
+    std::uint32_t random() {
+        // xorshift32
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 17;
+        random_state ^= random_state << 5;
+        return random_state;
+    }
+};
+
+JobSystem::JobSystem(std::uint32_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    for (std::uint32_t i = 0; i < thread_count; i++) {
+        m_workers.emplace(new Worker(i));
+    }
+    current_worker() = {this, 0};
+    for (std::uint32_t i = 1; i < thread_count; i++) {
+        m_threads.emplace([this, i] {
+            worker_main(i);
+        });
+    }
+}
+
+JobSystem::~JobSystem() {
+    m_running.store(false, std::memory_order_relaxed);
+    m_wake_epoch.fetch_add(1, std::memory_order_release);
+    m_wake_epoch.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+    if (current_worker().system == this) {
+        current_worker() = {};
+    }
+}
+
+JobSystem::Worker &JobSystem::local_worker() {
+    const auto &current = current_worker();
+    V2D_ASSERT(current.system == this, "Jobs can only be spawned or waited on from a worker thread");
+    return *m_workers[current.index];
+}
+
+JobSystem::Job &JobSystem::allocate_job() {
+    auto &worker = local_worker();
+    while (worker.free_list == nullptr) {
+        worker.free_list = worker.returned.exchange(nullptr, std::memory_order_acquire);
+        if (worker.free_list != nullptr) {
+            break;
+        }
+        // Every job is unfinished, so help run them until one frees up.
+        if (auto *job = find_job(worker)) {
+            execute(*job, worker);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    return *std::exchange(worker.free_list, worker.free_list->next);
+}
+
+void JobSystem::submit(Job &job, JobCounter &counter) {
+    job.counter = &counter;
+    counter.m_pending.fetch_add(1, std::memory_order_relaxed);
+    if (auto &worker = local_worker(); !worker.deque.push(&job)) {
+        execute(job, worker);
+        return;
+    }
+
+    // Pairs with the fence in a sleeping worker, so that either it sees the new job or we see it going to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed) != 0) {
+        m_wake_epoch.fetch_add(1, std::memory_order_release);
+        m_wake_epoch.notify_one();
+    }
+}
+
+JobSystem::Job *JobSystem::find_job(Worker &worker) {
+    if (auto *job = worker.deque.pop()) {
+        return job;
+    }
+    const auto worker_count = m_workers.size();
+    const auto start = worker.random();
+    for (std::uint32_t i = 0; i < worker_count; i++) {
+        auto &victim = *m_workers[(start + i) % worker_count];
+        if (&victim == &worker) {
+            continue;
+        }
+        if (auto *job = victim.deque.steal()) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job &job, Worker &worker) {
+    job.invoke(job.storage.data());
+    auto *counter = job.counter;
+    if (auto &owner = *m_workers[job.owner]; &owner == &worker) {
+        job.next = std::exchange(worker.free_list, &job);
+    } else {
+        auto &returned = owner.returned;
+        job.next = returned.load(std::memory_order_relaxed);
+        while (!returned.compare_exchange_weak(job.next, &job, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+    // The counter may be destroyed as soon as it reaches zero.
+    counter->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::wait(JobCounter &counter) {
+    auto &worker = local_worker();
+    while (!counter.done()) {
+        if (auto *job = find_job(worker)) {
+            execute(*job, worker);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::worker_main(std::uint32_t index) {
+    current_worker() = {this, index};
+    auto &worker = *m_workers[index];
+    std::uint32_t idle_count = 0;
+    while (m_running.load(std::memory_order_relaxed)) {
+        if (auto *job = find_job(worker)) {
+            execute(*job, worker);
+            idle_count = 0;
+            continue;
+        }
+        if (++idle_count < k_idle_spin_count) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Announce that we're going to sleep and then look again, so that a job spawned in between isn't missed.
+        const auto epoch = m_wake_epoch.load(std::memory_order_acquire);
+        m_sleeping.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (auto *job = find_job(worker)) {
+            m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+            execute(*job, worker);
+        } else if (m_running.load(std::memory_order_relaxed)) {
+            m_wake_epoch.wait(epoch, std::memory_order_acquire);
+            m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+        } else {
+            m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+        }
+        idle_count = 0;
+    }
+}
+
+} // namespace v2d
@@ -0,0 +1,143 @@
+#include <v2d/support/Trace.hh>
+
+#include <v2d/support/Array.hh>
+#include <v2d/support/Vector.hh>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace v2d {
+namespace {
+
+struct TraceEvent {
+    const char *name;
+    std::uint64_t start;
+    std::uint64_t duration;
+};
+
+// Single producer ring buffer owned by one thread. The owning thread never blocks: old events are overwritten once
+// the buffer is full. Readers detect overwritten slots by re-reading the head afterwards.
+class TraceBuffer {
+    static constexpr std::uint64_t k_capacity = 1u << 16u;
+
+    Array<TraceEvent, k_capacity> m_events{};
+    std::atomic<std::uint64_t> m_head{0};
+    const std::uint32_t m_thread_id;
+
+public:
+    explicit TraceBuffer(std::uint32_t thread_id) : m_thread_id(thread_id) {}
+
+    void push(const TraceEvent &event) {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        m_events[head % k_capacity] = event;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    template <typename F>
+    void read(F callback) const {
+        const auto head = m_head.load(std::memory_order_acquire);
+        const auto begin = head > k_capacity ? head - k_capacity : 0;
+        Vector<TraceEvent, std::uint64_t> events;
+        events.ensure_capacity(head - begin);
+        for (auto i = begin; i < head; i++) {
+            events.push(m_events[i % k_capacity]);
+        }
+        // Drop anything the owner may have overwritten whilst we were copying. The owner writes a slot before it
+        // publishes the new head, so the event at `new_head - k_capacity`, whose slot the next push reuses, may be
+        // mid-overwrite as well.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto new_head = m_head.load(std::memory_order_relaxed);
+        const auto valid_begin = new_head + 1 > k_capacity ? new_head + 1 - k_capacity : 0;
+        for (auto i = begin; i < head; i++) {
+            if (i >= valid_begin) {
+                callback(events[i - begin]);
+            }
+        }
+    }
+
+    std::uint32_t thread_id() const { return m_thread_id; }
+};
+
+class TraceRegistry {
+    std::mutex m_mutex;
+    Vector<std::unique_ptr<TraceBuffer>> m_buffers;
+
+public:
+    TraceBuffer &create_buffer() {
+        std::scoped_lock lock(m_mutex);
+        return *m_buffers.emplace(new TraceBuffer(m_buffers.size()));
+    }
+
+    template <typename F>
+    void for_each_buffer(F callback) {
+        std::scoped_lock lock(m_mutex);
+        for (const auto &buffer : m_buffers) {
+            callback(*buffer);
+        }
+    }
+};
+
+TraceRegistry &registry() {
+    static TraceRegistry registry;
+    return registry;
+}
+
+TraceBuffer &thread_buffer() {
+    // Buffers are owned by the registry so that events from exited threads can still be exported.
+    thread_local TraceBuffer &buffer = registry().create_buffer();
+    return buffer;
+}
+
+std::uint64_t timestamp() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    const auto now = std::chrono::steady_clock::now();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - epoch).count());
+}
+
+void write_json_string(std::FILE *file, const char *string) {
+    std::fputc('"', file);
+    for (const char *c = string; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            std::fprintf(file, "\\u%04x", static_cast<unsigned>(*c));
+        } else {
+            std::fputc(*c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+} // namespace
+
+TraceZone::TraceZone(const char *name) : m_name(name), m_start(timestamp()) {}
+
+TraceZone::~TraceZone() {
+    thread_buffer().push({m_name, m_start, timestamp() - m_start});
+}
+
+bool export_chrome_trace(const char *path) {
+    std::FILE *file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fputs("{\"traceEvents\":[", file);
+    bool first = true;
+    registry().for_each_buffer([&](const TraceBuffer &buffer) {
+        buffer.read([&](const TraceEvent &event) {
+            std::fputs(first ? "\n{\"name\":" : ",\n{\"name\":", file);
+            write_json_string(file, event.name);
+            std::fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer.thread_id(),
+                         static_cast<double>(event.start) / 1000.0, static_cast<double>(event.duration) / 1000.0);
+            first = false;
+        });
+    });
+    std::fputs("\n],\"displayTimeUnit\":\"ms\"}\n", file);
+    return std::fclose(file) == 0;
+}
+
+} // namespace v2d